@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint>
+
+// Brojac alokacija na heap-u (zamenjen globalni operator new u AllocationCounter.cpp).
+// Sluzi za proveru da ponovljeni ciklusi (npr. projekcije) ne alociraju nista.
+// Zamena postoji samo u build-u sa COUNT_ALLOCATIONS (npr. /D COUNT_ALLOCATIONS), da obican
+// kiosk ne placa atomski brojac na svakoj alokaciji.
+bool allocationCounterAvailable();
+uint64_t allocationCount();
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef ARRIVAL_SCHEDULE_H
+#define ARRIVAL_SCHEDULE_H
+
+#include <string>
+#include <vector>
+#include "CounterRng.h"
+
+// Kada ko stize pred salu, racunato od otvaranja vrata (startProjection)
+enum ArrivalMode {
+    ARRIVE_AT_ONCE,  // svi su vec pred vratima (originalno ponasanje)
+    ARRIVE_POISSON,  // ravnomerno tokom prozora dolaska (Poisson-ov proces sa stalnom stopom)
+    ARRIVE_HISTOGRAM // empirijska raspodela: tezine po jednakim intervalima prozora
+};
+
+struct ArrivalSchedule {
+    ArrivalMode mode = ARRIVE_AT_ONCE;
+    float window = 1200.0f;       // trajanje dolaska u sekundama (20 minuta pred film)
+    std::vector<float> histogram; // samo za ARRIVE_HISTOGRAM; ne mora biti normalizovan
+
+    // Vreme dolaska jednog coveka. Kod Poisson-ovog procesa su, za dati broj dolazaka, vremena
+    // nezavisna i ravnomerna na prozoru - zato svako dobija svoje vreme iz svog toka, bez redosleda.
+    float sample(const CounterRng& rng, uint64_t stream, uint64_t counter) const {
+        if (mode == ARRIVE_AT_ONCE) return 0.0f;
+        float u = rng.uniform(stream, counter, 0);
+        if (mode == ARRIVE_POISSON || histogram.empty()) return u * window;
+
+        // Inverzna funkcija raspodele po intervalima, pa ravnomerno unutar izabranog intervala
+        float total = 0.0f;
+        for (float w : histogram) total += w;
+        if (total <= 0.0f) return u * window;
+        float target = u * total;
+        size_t bin = 0;
+        while (bin + 1 < histogram.size() && target >= histogram[bin]) {
+            target -= histogram[bin];
+            bin++;
+        }
+        float binWidth = window / histogram.size();
+        return (bin + rng.uniform(stream, counter, 1)) * binWidth;
+    }
+
+    // Tekstualni fajl sa tezinama intervala (npr. broj dolazaka po minutu), razdvojene razmakom ili novim redom
+    bool loadHistogram(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Paket slika: atlas pripremljen unapred (TextureAtlas::writePack), da se pri pokretanju ne
+// dekodira PNG niti racunaju mipmape. Raspored fajla:
+//   AssetPackHeader, spriteCount x AssetPackSprite, levels x AssetPackLevel,
+//   pa nivoi atlasa (RGBA8, vec obrnuti, sa okvirom), svaki poravnat na ASSET_PACK_ALIGN.
+const uint32_t ASSET_PACK_MAGIC = 0x31504153; // "SAP1"
+const uint32_t ASSET_PACK_VERSION = 1;
+const uint32_t ASSET_PACK_RGBA8 = 0;
+const uint32_t ASSET_PACK_ALIGN = 4096;      // stranica: nivoi se citaju direktno iz mapiranog fajla
+
+struct AssetPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width, height;
+    uint32_t levels;       // nivo 0 + mipmape
+    uint32_t spriteCount;
+    uint32_t format;
+    uint32_t reserved;
+};
+
+// Izvorna slika se pamti po velicini i vremenu izmene: ako se PNG promeni, paket je zastareo
+struct AssetPackSprite {
+    char name[64];
+    float u, v, du, dv;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+};
+
+struct AssetPackLevel {
+    uint32_t width, height;
+    uint64_t offset, size; // bajtovi od pocetka fajla
+};
+
+// Velicina i vreme izmene fajla; false ako ne postoji
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& mtime);
+
+// Ceo fajl mapiran samo za citanje
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != NULL; }
+
+    const unsigned char* bytes() const { return data; }
+    size_t size() const { return length; }
+
+private:
+    const unsigned char* data;
+    size_t length;
+    void* handle;
+};
+
+#endif
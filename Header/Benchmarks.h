@@ -0,0 +1,10 @@
+#pragma once
+
+// Merenja performansi koja se pokrecu iz komandne linije, bez otvaranja prozora
+int runJournalBenchmark();
+int runEventStreamBenchmark();
+int runFlowFieldBenchmark();
+int runDoorBenchmark();
+int runPersonPoolBenchmark();
+int runCompactPersonBenchmark();
+int runLodBenchmark();
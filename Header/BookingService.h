@@ -0,0 +1,95 @@
+#pragma once
+#ifndef BOOKING_SERVICE_H
+#define BOOKING_SERVICE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class SeatManager;
+class SeatSnapshotStore;
+
+// Lokalni servis za rezervacije preko Unix socket-a (epoll petlja).
+//
+// Protokol je tekstualan, jedan zahtev po liniji, sa brojem zahteva koji klijent bira:
+//   "<id> RESERVE <sediste>"  ->  "<id> OK" / "<id> ERR TAKEN"
+//   "<id> CANCEL <sediste>"   ->  "<id> OK" / "<id> ERR NOT_RESERVED"
+//   "<id> BUY <n>"            ->  "<id> OK <red>" / "<id> ERR NO_SPACE"
+// Klijent moze da posalje vise zahteva bez cekanja, odgovori stizu sa istim id-em.
+//
+// Svi zahtevi koji stignu u jednom poll() pozivu se primenjuju zajedno, posle toga
+// ide jedan upis u zurnal, pa tek onda odgovori (odgovor "OK" znaci da je promena trajna).
+class BookingService {
+public:
+    // Statistika
+    uint64_t requestsServed = 0;
+    uint64_t batchesApplied = 0;
+    size_t largestBatch = 0;
+
+    // Posle svake primenjene grupe (npr. da probudi glavnu petlju koja spava dok se nista ne menja)
+    std::function<void()> onApplied;
+
+    BookingService();
+    ~BookingService();
+
+    bool start(const std::string& socketPath);
+    void stop();
+    bool isRunning() const { return listenFd >= 0; }
+
+    // Jedan tick servisa. timeoutMs = 0 za poziv iz glavne petlje, -1 za cekanje na zahteve.
+    // Ako acceptWrites nije postavljen (projekcija je u toku), svi zahtevi dobijaju "ERR BUSY".
+    int poll(SeatManager& sm, int timeoutMs, bool acceptWrites);
+
+    // Servis na svojoj niti: svaka grupa se primenjuje pod snapshots.writerMutex i objavljuje
+    // novi snimak sale, pa glavna petlja (renderer) nikad ne vidi poluprimenjenu grupu.
+    // acceptWrites se cita pod istim mutex-om, pa ga glavna petlja menja samo dok ga drzi.
+    bool startThread(SeatManager& sm, SeatSnapshotStore& snapshots, std::atomic<bool>& acceptWrites);
+
+private:
+    struct Connection {
+        std::string in;
+        std::string out;
+        bool wantsWrite = false;
+        bool peerClosed = false; // klijent vise ne salje; zatvara se kad ode poslednji odgovor
+    };
+
+    // Najvise bajtova nedovrsene linije po konekciji
+    static const size_t MAX_PENDING_INPUT = 64 * 1024;
+
+    struct Request {
+        int fd;
+        std::string id;
+        std::string op;
+        int arg;
+    };
+
+    int listenFd;
+    int epollFd;
+    std::string path;
+    std::unordered_map<int, Connection> connections;
+    std::vector<Request> batch;
+
+    SeatSnapshotStore* snapshots;
+    std::atomic<bool>* writesOpen; // samo za servis na svojoj niti
+    std::thread worker;
+    std::atomic<bool> stopping;
+
+    void acceptAll();
+    void readAll(int fd);
+    void parseLines(int fd, Connection& c);
+    void flush(int fd);
+    void updateEvents(int fd, const Connection& c);
+    void closeConnection(int fd);
+};
+
+// Headless servis: samo sedista + zurnal, bez prozora
+int runBookingDaemon(const std::string& socketPath, bool useJournal);
+
+// Generator opterecenja: connections konekcija, svaka sa depth zahteva u letu, ukupno total zahteva
+int runBookingLoadGenerator(const std::string& socketPath, int connections, int depth, int total);
+
+#endif
@@ -7,6 +7,9 @@
 #include <iostream>
 #include "PersonManager.h"
 #include "SeatManager.h"
+#include "CounterRng.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
 #include "Util.h" // Potrebno za loadImageToTexture
 
 enum SimState {
@@ -26,35 +29,48 @@ public:
     int frameCounter;
     float screenR, screenG, screenB;
 
+    // Trajanje poslednjeg ulaska (za izvestaj o obrtu sale)
+    float enterDuration;
+
+    // Boje platna zavise samo od semena, broja projekcije i frejma filma
+    CounterRng rng;
+    uint64_t projection;
+
     // --- NOVO: Teksture za vrata ---
-    unsigned int texDoorOpen;
-    unsigned int texDoorClose;
+    Sprite doorOpen;
+    Sprite doorClose;
+
+    // loadTextures = false za rad bez prozora (reprodukcija snimka, merenja)
+    CinemaSimulator(bool loadTextures = true) {
+        projection = 0;
+        reset();
+        if (!loadTextures) return;
 
-    CinemaSimulator() {
         // Ucitavanje tekstura vrata
-        texDoorOpen = loadImageToTexture("open.png");
-        texDoorClose = loadImageToTexture("close.png");
+        doorOpen.texture = loadImageToTexture("open.png");
+        doorClose.texture = loadImageToTexture("close.png");
 
-        if (texDoorOpen == 0 || texDoorClose == 0) {
+        if (doorOpen.texture == 0 || doorClose.texture == 0) {
             std::cout << "UPOZORENJE: Nedostaju slike 'open.png' ili 'close.png'!" << std::endl;
         }
-
-        reset();
     }
 
     void reset() {
         currentState = IDLE;
         movieTimer = 0.0f;
         frameCounter = 0;
+        enterDuration = 0.0f;
         screenR = 0.9f; screenG = 0.9f; screenB = 0.9f;
     }
 
-    void startProjection(PersonManager& pm, SeatManager& sm) {
+    // Ljudi ulaze na osnovu snimka sale (sedista se mogu menjati i sa drugih niti)
+    void startProjection(PersonManager& pm, const std::vector<Seat>& seats) {
         if (currentState == IDLE) {
-            pm.spawnPeople(sm);
+            projection++;
+            pm.spawnPeople(seats);
 
             // Logika za praznu salu (Odmah film)
-            if (pm.people.empty()) {
+            if (pm.count() == 0 && pm.pendingArrivals() == 0) {
                 std::cout << "Sala prazna! Preskacemo ulazak, film odmah pocinje." << std::endl;
                 currentState = MOVIE;
                 movieTimer = 0.0f;
@@ -80,7 +96,10 @@ public:
                 currentState = MOVIE;
                 movieTimer = 0.0f;
                 frameCounter = 0;
+                enterDuration = pm.clock;
                 std::cout << "Svi su seli. Film pocinje! Vrata se zatvaraju." << std::endl;
+                std::cout << "Ulazak: " << enterDuration << " s" << std::endl;
+                pm.printDoorStats(false);
             }
             break;
 
@@ -90,9 +109,10 @@ public:
 
             // Treperenje ekrana
             if (frameCounter % 20 == 0) {
-                screenR = (float)rand() / RAND_MAX;
-                screenG = (float)rand() / RAND_MAX;
-                screenB = (float)rand() / RAND_MAX;
+                uint64_t tick = (projection << 32) | (uint32_t)frameCounter;
+                screenR = rng.uniform(RNG_STREAM_SCREEN, tick, 0);
+                screenG = rng.uniform(RNG_STREAM_SCREEN, tick, 1);
+                screenB = rng.uniform(RNG_STREAM_SCREEN, tick, 2);
             }
 
             if (movieTimer >= MOVIE_DURATION) {
@@ -100,9 +120,9 @@ public:
                 std::cout << "Film gotov." << std::endl;
 
                 // Ako je sala prazna, odmah reset
-                if (pm.people.empty()) {
+                if (pm.count() == 0) {
                     std::cout << "Sala je bila prazna. Resetujem." << std::endl;
-                    for (auto& s : sm.seats) s.state = FREE;
+                    sm.resetAllSeats();
                     reset();
                 }
                 else {
@@ -115,8 +135,12 @@ public:
 
         case EXITING:
             if (pm.areAllGone()) {
+                std::cout << "Izlazak: " << pm.clock << " s" << std::endl;
+                pm.printDoorStats(true);
+                std::cout << "Obrt sale: ulazak " << enterDuration << " s + film " << MOVIE_DURATION << " s + izlazak "
+                    << pm.clock << " s = " << enterDuration + MOVIE_DURATION + pm.clock << " s" << std::endl;
                 pm.clear();
-                for (auto& s : sm.seats) s.state = FREE;
+                sm.resetAllSeats();
                 reset();
                 std::cout << "Sala prazna. Reset sistema." << std::endl;
             }
@@ -129,37 +153,20 @@ public:
     }
 
     // --- AZURIRANO CRTANJE VRATA ---
-    void drawDoors(int uPosLoc, int uSizeLoc, int uColorLoc, int uUseTextureLoc) {
-        // Obavezno ukljucujemo teksture
-        glUniform1i(uUseTextureLoc, 1);
-        glActiveTexture(GL_TEXTURE0);
-
-        // Biramo teksturu na osnovu stanja
-        if (currentState == ENTERING || currentState == EXITING) {
-            // Vrata otvorena
-            glBindTexture(GL_TEXTURE_2D, texDoorOpen);
-        }
-        else {
-            // Vrata zatvorena (IDLE ili MOVIE)
-            glBindTexture(GL_TEXTURE_2D, texDoorClose);
-        }
+    void drawDoors(const std::vector<Door>& doors, SpriteBatch& batch) {
+        batch.nextLayer();
 
-        // Boja bela da bi tekstura imala svoje originalne boje
-        glUniform4f(uColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+        // Biramo sliku na osnovu stanja: otvorena pri ulasku/izlasku, inace (IDLE ili MOVIE) zatvorena
+        const Sprite& door = (currentState == ENTERING || currentState == EXITING) ? doorOpen : doorClose;
 
-        // Pozicija (Gornji levi ugao)
-        glUniform2f(uPosLoc, -0.98f, 0.6f);
-        glUniform2f(uSizeLoc, 0.2f, 0.3f);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        // Pozicija (donji levi ugao), ista slika za sva vrata; boja bela da bi tekstura imala svoje originalne boje
+        for (const Door& d : doors) batch.draw(door, d.x, d.y, 0.2f, 0.3f, 1.0f, 1.0f, 1.0f, 1.0f);
     }
 
-    void drawScreen(int uPosLoc, int uSizeLoc, int uColorLoc, int uUseTextureLoc) {
+    void drawScreen(SpriteBatch& batch) {
         // Platno nema teksturu, samo boju
-        glUniform1i(uUseTextureLoc, 0);
-        glUniform4f(uColorLoc, screenR, screenG, screenB, 1.0f);
-        glUniform2f(uPosLoc, -0.6f, 0.6f);
-        glUniform2f(uSizeLoc, 1.2f, 0.3f);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        batch.nextLayer();
+        batch.drawRect(-0.6f, 0.6f, 1.2f, 0.3f, screenR, screenG, screenB, 1.0f);
     }
 };
 
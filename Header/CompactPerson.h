@@ -0,0 +1,57 @@
+#pragma once
+#ifndef COMPACT_PERSON_H
+#define COMPACT_PERSON_H
+
+#include <cstdint>
+
+// Sazet zapis coveka za velike sale (stadion sa milion ljudi): 20 bajtova umesto ~52.
+// Cetiri bool-a iz Person (reachedRow, seated, isExiting, hasLeft) su u stvari jedna faza,
+// pa staju u dva bita; cilj (sediste) i polazna tacka (vrata) se citaju iz zajednickih tabela.
+
+enum PersonPhase {
+    PHASE_ENTERING = 0,
+    PHASE_SEATED = 1,
+    PHASE_EXITING = 2,
+    PHASE_LEFT = 3
+};
+
+const uint8_t PERSON_PHASE_MASK = 0x03;
+const uint8_t PERSON_SECOND_LEG = 0x04; // reachedRow: druga deonica puta (red -> sediste, ili vrata -> napolje)
+
+// Pozicije u fiksnom zarezu: NDC * 16384 (opseg -2..2, korak ~0.00006)
+const float PERSON_POS_SCALE = 16384.0f;
+// Brzina u NDC/s, 16 bita razlomka (brzine su manje od 1)
+const float PERSON_SPEED_SCALE = 65536.0f;
+
+struct CompactPerson {
+    int16_t x, y;
+    uint32_t seat;   // indeks u tabeli ciljeva (SeatTarget)
+    int32_t navCell; // samo za polje toka
+    float wait;      // ulazak: koliko jos ceka red na vratima (< 0 kada je prosao)
+    uint16_t speed;
+    uint8_t door;
+    uint8_t flags;   // faza (2 bita) + PERSON_SECOND_LEG
+};
+
+// Jedan unos po sedistu, zajednicki za sve ljude (umesto targetX/targetY u svakom coveku)
+struct SeatTarget {
+    int16_t x, y; // isti fiksni zarez kao pozicije coveka
+    int32_t cell; // celija iz koje se prilazi sedistu (polje toka), inace -1
+};
+
+inline int16_t toFixedPos(float v) {
+    float f = v * PERSON_POS_SCALE;
+    return (int16_t)(f >= 0.0f ? f + 0.5f : f - 0.5f); // zaokruzivanje bez poziva lround
+}
+
+inline float fromFixedPos(int16_t v) {
+    return v / PERSON_POS_SCALE;
+}
+
+// Vrednost koju fiksni zapis moze tacno da predstavi - ciljevi se zaokruzuju isto kao pozicije,
+// da bi provere "stigao na cilj" ostale tacne posle svakog upisa u 16 bita
+inline float quantizePos(float v) {
+    return fromFixedPos(toFixedPos(v));
+}
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+// Generator slucajnih brojeva bez stanja (counter-based, u stilu SplitMix64): svaki broj je hes
+// od (seme, tok, brojac, redni broj izvlacenja). Isto seme uvek daje iste brojeve, bez obzira na
+// redosled poziva i broj niti - nema zajednickog stanja koje bi se delilo ili zakljucavalo.
+//
+// Tok (stream) odvaja namene i agente (npr. RNG_STREAM_AGENT + id sedista), brojac je obicno
+// tick ili broj projekcije.
+
+// Namene (gornji biti toka), da se brojevi za razlicite stvari nikad ne poklope
+const uint64_t RNG_STREAM_SPAWN = 1ull << 56;     // koliko ljudi dolazi i koja sedista
+const uint64_t RNG_STREAM_AGENT = 2ull << 56;     // + id agenta (indeks sedista)
+const uint64_t RNG_STREAM_SCREEN = 3ull << 56;    // treperenje platna
+const uint64_t RNG_STREAM_OCCUPANCY = 4ull << 56; // Monte Karlo: koja sedista su prodata u ciklusu
+const uint64_t RNG_STREAM_ARRIVAL = 5ull << 56;   // + id agenta: vreme dolaska pred salu
+
+class CounterRng {
+public:
+    explicit CounterRng(uint64_t seed = 0) { setSeed(seed); }
+
+    void setSeed(uint64_t s) {
+        seed = s;
+        key = mix(s + 0x9E3779B97F4A7C15ull);
+    }
+
+    uint64_t getSeed() const { return seed; }
+
+    // 64 slucajna bita za (tok, brojac, izvlacenje)
+    uint64_t bits(uint64_t stream, uint64_t counter, uint32_t draw = 0) const {
+        uint64_t z = mix(key ^ (stream * 0x9E3779B97F4A7C15ull));
+        z = mix(z ^ (counter * 0xC2B2AE3D27D4EB4Full));
+        return mix(z + draw * 0xD6E8FEB86659FD93ull);
+    }
+
+    // Ravnomerno u [0, 1)
+    float uniform(uint64_t stream, uint64_t counter, uint32_t draw = 0) const {
+        return (float)(bits(stream, counter, draw) >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // Ravnomerno u [0, n) (mnozenje umesto modula, bez primetne pristrasnosti za male n)
+    uint32_t below(uint32_t n, uint64_t stream, uint64_t counter, uint32_t draw = 0) const {
+        return (uint32_t)(((bits(stream, counter, draw) >> 32) * n) >> 32);
+    }
+
+private:
+    uint64_t seed;
+    uint64_t key;
+
+    // SplitMix64 zavrsno mesanje
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+#ifndef CROWD_LOD_H
+#define CROWD_LOD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Nivo detalja za ogromne sale: pojedinacni ljudi se simuliraju samo u oblasti u fokusu (deo sale
+// koji se gleda), a svi ostali su "zbirni" - bez koraka po tiku. Zbirni covek ide osnovnom putanjom
+// (dva prava dela), pa se njegov polozaj i vreme dolaska racunaju direktno iz vremena polaska;
+// obradjuje se samo kada se nesto desi (ulazi u fokus, stize na sediste ili do vrata).
+// Za prikaz se zbirni ljudi sabiraju u gustinu na gruboj mrezi.
+
+// Deo sale u kome se ljudi simuliraju pojedinacno (NDC)
+struct FocusRect {
+    float x0 = -1.0f, y0 = -1.0f, x1 = 1.0f, y1 = 1.0f;
+
+    bool contains(float x, float y) const {
+        return x >= x0 && x <= x1 && y >= y0 && y <= y1;
+    }
+};
+
+// Putanja od dva prava dela: A -> B -> C (B je ugao), parametrizovana predjenim putem s
+struct LegPath {
+    float ax, ay, bx, by, cx, cy;
+    float first, length; // duzina prvog dela i cele putanje
+
+    LegPath(float ax, float ay, float bx, float by, float cx, float cy)
+        : ax(ax), ay(ay), bx(bx), by(by), cx(cx), cy(cy) {
+        first = std::fabs(bx - ax) + std::fabs(by - ay);
+        length = first + std::fabs(cx - bx) + std::fabs(cy - by);
+    }
+
+    void pointAt(float s, float& x, float& y) const {
+        if (s <= first) lerp(ax, ay, bx, by, first, s, x, y);
+        else lerp(bx, by, cx, cy, length - first, s - first, x, y);
+    }
+
+    // Prvo s' >= s na kome je putanja u fokusu; -1 ako do kraja ne ulazi
+    float enterFocus(const FocusRect& r, float s) const {
+        float e = clip(ax, ay, bx, by, 0.0f, first, r, s);
+        if (e >= 0.0f) return e;
+        return clip(bx, by, cx, cy, first, length - first, r, s);
+    }
+
+private:
+    static void lerp(float x0, float y0, float x1, float y1, float len, float s, float& x, float& y) {
+        float u = len > 0.0f ? std::min(std::max(s / len, 0.0f), 1.0f) : 1.0f;
+        x = x0 + (x1 - x0) * u;
+        y = y0 + (y1 - y0) * u;
+    }
+
+    // Deo duzi (pocinje na putu offset, duzine len) unutar pravougaonika, od puta s nadalje
+    static float clip(float x0, float y0, float x1, float y1, float offset, float len, const FocusRect& r, float s) {
+        if (s > offset + len) return -1.0f;
+        float u0 = 0.0f, u1 = 1.0f;
+        if (!clipAxis(x0, x1 - x0, r.x0, r.x1, u0, u1) || !clipAxis(y0, y1 - y0, r.y0, r.y1, u0, u1)) return -1.0f;
+        float e = offset + u0 * len;
+        float end = offset + u1 * len;
+        if (end < s) return -1.0f;
+        return std::max(e, s);
+    }
+
+    static bool clipAxis(float p, float d, float lo, float hi, float& u0, float& u1) {
+        if (d == 0.0f) return p >= lo && p <= hi;
+        float a = (lo - p) / d, b = (hi - p) / d;
+        if (a > b) std::swap(a, b);
+        u0 = std::max(u0, a);
+        u1 = std::min(u1, b);
+        return u0 <= u1;
+    }
+};
+
+// Zbirni covek: ne pomera se po tiku. Na putu s0 je bio u trenutku t0 (pre t0 ceka na vratima).
+struct LodAgent {
+    uint32_t seat;
+    float speed;
+    uint8_t door;
+    uint8_t phase;        // PersonPhase (ulazi, sedi, izlazi)
+    uint8_t credited;     // ulazak kroz vrata je vec upisan u statistiku vrata
+    float t0, s0;
+    int densityCell;      // celija grube mreze u koju je trenutno uracunat (-1: nigde)
+};
+
+enum LodEventKind {
+    LOD_PROMOTE, // ulazi u fokus: postaje pojedinacni covek
+    LOD_ARRIVE   // stize na kraj putanje (sediste ili vrata)
+};
+
+struct LodEvent {
+    float time;
+    int agent;
+    uint8_t kind;
+};
+
+// Za std::*_heap: na vrhu je najraniji dogadjaj
+inline bool laterLodEvent(const LodEvent& a, const LodEvent& b) {
+    return a.time > b.time || (a.time == b.time && a.agent > b.agent);
+}
+
+// Broj zbirnih ljudi po celiji grube mreze preko cele scene (NDC -1..1)
+class DensityGrid {
+public:
+    int size = 64;
+    std::vector<int> counts;
+
+    void init(int n) {
+        size = n;
+        counts.assign(size * size, 0);
+    }
+
+    int cellAt(float x, float y) const {
+        int cx = std::min(std::max((int)((x + 1.0f) * 0.5f * size), 0), size - 1);
+        int cy = std::min(std::max((int)((y + 1.0f) * 0.5f * size), 0), size - 1);
+        return cy * size + cx;
+    }
+
+    // Premesta doprinos jednog coveka (cell -1: dodaje/uklanja)
+    void move(int& current, int cell) {
+        if (current == cell) return;
+        if (current >= 0) counts[current]--;
+        if (cell >= 0) counts[cell]++;
+        current = cell;
+    }
+
+    float cellSize() const { return 2.0f / size; }
+};
+
+#endif
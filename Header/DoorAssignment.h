@@ -0,0 +1,204 @@
+#pragma once
+#ifndef DOOR_ASSIGNMENT_H
+#define DOOR_ASSIGNMENT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Jedna vrata sale. Ljudi ulaze/izlaze u tacki (x, y) - donji levi ugao slike vrata.
+struct Door {
+    float x, y;
+    float headway; // sekundi izmedju dva prolaska kroz vrata (propusna moc = 1 / headway)
+
+    // Statistika poslednjeg ulaska/izlaska (vreme od pocetka faze)
+    int entered, exited;
+    float lastEnter, lastExit;
+    float nextFree; // kada vrata mogu da propuste sledeceg (izlazak)
+
+    Door(float x = -0.98f, float y = 0.6f, float headway = 0.15f)
+        : x(x), y(y), headway(headway), entered(0), exited(0), lastEnter(0.0f), lastExit(0.0f), nextFree(0.0f) {}
+
+    void resetStats() {
+        entered = exited = 0;
+        lastEnter = lastExit = nextFree = 0.0f;
+    }
+};
+
+// Raspored za salu sa 1-6 vrata: prva su originalna (gore levo), ostala naizmenicno desno/levo
+inline std::vector<Door> defaultDoorLayout(int count) {
+    static const float pos[6][2] = {
+        { -0.98f, 0.6f }, { 0.78f, 0.6f },
+        { -0.98f, -0.9f }, { 0.78f, -0.9f },
+        { -0.98f, -0.15f }, { 0.78f, -0.15f }
+    };
+    if (count < 1) count = 1;
+    if (count > 6) count = 6;
+    std::vector<Door> doors;
+    for (int i = 0; i < count; i++) doors.push_back(Door(pos[i][0], pos[i][1]));
+    return doors;
+}
+
+// Rasporedjivanje ljudi na vrata tako da je ukupno ocekivano vreme (put + cekanje u redu) najmanje.
+// Cekanje: k-ti covek kroz vrata d ceka k * headway(d).
+//
+// travel[a * doorCount + d] = vreme puta agenta a do vrata d (u sekundama).
+// Rezultat: doorOf[a] = vrata, slotOf[a] = mesto u redu na tim vratima (0 = prvi).
+// queuedBefore (opciono): koliko je ljudi vec u redu na svakim vratima iz ranijih delova iste grupe;
+// tada se uvek koristi pohlepni algoritam i mesta se nastavljaju od toga.
+class DoorAssigner {
+public:
+    // Do ovoliko agenata se koristi tacan (madjarski) algoritam, preko toga pohlepni sa redom prioriteta
+    int optimalLimit = 100;
+
+    // Statistika poslednjeg rasporedjivanja
+    bool lastOptimal = false;
+    double lastCost = 0.0;
+
+    void assign(const std::vector<float>& travel, int agentCount, const std::vector<Door>& doors,
+        std::vector<int>& doorOf, std::vector<int>& slotOf, const std::vector<int>* queuedBefore = NULL) {
+        int doorCount = (int)doors.size();
+        doorOf.assign(agentCount, 0);
+        slotOf.assign(agentCount, 0);
+        if (agentCount == 0 || doorCount == 0) return;
+
+        lastOptimal = doorCount > 1 && agentCount <= optimalLimit && queuedBefore == NULL;
+        if (lastOptimal) assignOptimal(travel, agentCount, doors, doorOf, slotOf);
+        else assignGreedy(travel, agentCount, doors, doorOf, slotOf, queuedBefore);
+
+        lastCost = 0.0;
+        for (int a = 0; a < agentCount; a++) {
+            lastCost += travel[a * doorCount + doorOf[a]] + slotOf[a] * doors[doorOf[a]].headway;
+        }
+    }
+
+private:
+
+    // Pohlepno: uvek se dodeljuje najjeftiniji par (agent, vrata), iz binarnog heap-a. Cena vrata raste tek
+    // kada neko zauzme mesto u redu, pa se zastareli unosi samo ponovo ubace sa novom cenom (lenjo azuriranje).
+    // O(A * D * log(A * D)).
+    void assignGreedy(const std::vector<float>& travel, int agentCount, const std::vector<Door>& doors,
+        std::vector<int>& doorOf, std::vector<int>& slotOf, const std::vector<int>* queuedBefore) {
+        int doorCount = (int)doors.size();
+        std::vector<Entry>& heap = greedyHeap;
+        if (queuedBefore) queued = *queuedBefore;
+        else queued.assign(doorCount, 0);
+        done.assign(agentCount, 0);
+
+        heap.clear();
+        for (int a = 0; a < agentCount; a++) {
+            for (int d = 0; d < doorCount; d++) heap.push_back({ travel[a * doorCount + d] + queued[d] * doors[d].headway, a, d, queued[d] });
+        }
+        std::make_heap(heap.begin(), heap.end(), std::greater<Entry>());
+
+        int left = agentCount;
+        while (left > 0 && !heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            Entry e = heap.back();
+            heap.pop_back();
+            if (done[e.agent]) continue;
+            if (e.queued != queued[e.door]) {
+                e.queued = queued[e.door];
+                e.cost = travel[e.agent * doorCount + e.door] + e.queued * doors[e.door].headway;
+                heap.push_back(e);
+                std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+                continue;
+            }
+            done[e.agent] = 1;
+            doorOf[e.agent] = e.door;
+            slotOf[e.agent] = queued[e.door]++;
+            left--;
+        }
+    }
+
+    // Tacno: madjarski algoritam (sa potencijalima) nad matricom agent x (vrata, mesto u redu).
+    // O(A^2 * A * D) - samo za manje sale.
+    void assignOptimal(const std::vector<float>& travel, int agentCount, const std::vector<Door>& doors,
+        std::vector<int>& doorOf, std::vector<int>& slotOf) {
+        int doorCount = (int)doors.size();
+        int n = agentCount;
+        int m = agentCount * doorCount; // kolona: d * agentCount + k
+        const double INF = std::numeric_limits<double>::max();
+
+        u.assign(n + 1, 0.0);
+        v.assign(m + 1, 0.0);
+        minv.resize(m + 1);
+        p.assign(m + 1, 0);
+        way.assign(m + 1, 0);
+        used.resize(m + 1);
+
+        for (int i = 1; i <= n; i++) {
+            p[0] = i;
+            int j0 = 0;
+            std::fill(minv.begin(), minv.end(), INF);
+            std::fill(used.begin(), used.end(), 0);
+            do {
+                used[j0] = 1;
+                int i0 = p[j0], j1 = 0;
+                double delta = INF;
+                for (int j = 1; j <= m; j++) {
+                    if (used[j]) continue;
+                    int d = (j - 1) / agentCount, k = (j - 1) % agentCount;
+                    double cost = travel[(i0 - 1) * doorCount + d] + k * (double)doors[d].headway;
+                    double cur = cost - u[i0] - v[j];
+                    if (cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+                for (int j = 0; j <= m; j++) {
+                    if (used[j]) {
+                        u[p[j]] += delta;
+                        v[j] -= delta;
+                    }
+                    else minv[j] -= delta;
+                }
+                j0 = j1;
+            } while (p[j0] != 0);
+            do {
+                int j1 = way[j0];
+                p[j0] = p[j1];
+                j0 = j1;
+            } while (j0 != 0);
+        }
+
+        for (int j = 1; j <= m; j++) {
+            if (p[j] == 0) continue;
+            doorOf[p[j] - 1] = (j - 1) / agentCount;
+            slotOf[p[j] - 1] = (j - 1) % agentCount;
+        }
+
+        // Optimum uvek koristi mesta 0..n-1 na svakim vratima (nize mesto je uvek jeftinije),
+        // ali ih sazimamo za slucaj jednakih cena (headway = 0)
+        for (int d = 0; d < doorCount; d++) {
+            queue.clear();
+            for (int a = 0; a < n; a++) {
+                if (doorOf[a] == d) queue.push_back(std::make_pair(slotOf[a], a));
+            }
+            std::sort(queue.begin(), queue.end());
+            for (size_t k = 0; k < queue.size(); k++) slotOf[queue[k].second] = (int)k;
+        }
+    }
+
+    // Radni nizovi se cuvaju izmedju poziva, da ponovljeno rasporedjivanje ne alocira
+    struct Entry {
+        float cost;
+        int agent, door, queued;
+        bool operator>(const Entry& o) const { return cost > o.cost; }
+    };
+    std::vector<Entry> greedyHeap;
+    std::vector<int> queued;
+    std::vector<uint8_t> done;
+    std::vector<double> u, v, minv;
+    std::vector<int> p, way;
+    std::vector<uint8_t> used;
+    std::vector<std::pair<int, int> > queue;
+};
+
+#endif
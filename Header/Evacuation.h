@@ -0,0 +1,227 @@
+#pragma once
+#ifndef EVACUATION_H
+#define EVACUATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "SeatManager.h"
+#include "FlowField.h"
+#include "DoorAssignment.h"
+#include "CounterRng.h"
+
+const uint8_t EVAC_NO_DOOR = 255; // celija bez puta do vrata
+
+// Evakuacija pune sale: svi krecu istovremeno sa svojih sedista ka najblizim vratima (po duzini
+// puta kroz prolaze), celija mreze prima najvise capacity ljudi, a vrata propustaju jednog na
+// svakih headway sekundi. Rezultat: ukupno vreme, protok po vratima i celije gde se najvise ceka.
+//
+// Svaka celija ide ka susedu sa manjim rastojanjem do svojih najblizih vrata, pa rastojanje duz
+// puta strogo opada: lanac cekanja uvek zavrsava na vratima i nema zaglavljivanja (dva coveka
+// nikad ne traze jedan drugome celiju).
+//
+// Ko ceka na punu celiju, "parkira" se na njoj i ne obradjuje se dok se celija ne oslobodi;
+// po koraku se obradjuju samo ljudi koji se stvarno krecu, pa je cena srazmerna kretanju, a ne
+// broju ljudi u redovima.
+class Evacuation {
+public:
+    int capacity = 1;          // ljudi po celiji mreze
+    float dt = 1.0f / 75.0f;
+
+    // Rezultati poslednjeg pokretanja
+    float totalTime = 0.0f;
+    float time90 = 0.0f;       // kada je 90% ljudi napolju
+    int evacuated = 0;
+    int stranded = 0;          // sedista bez puta do ijednih vrata
+    int ticks = 0;
+    uint64_t agentSteps = 0;   // obradjenih (agent, korak) parova
+    std::vector<float> cellWait; // ukupno cekanje (covek-sekundi) po celiji
+
+    // Najbliza vrata i sledeca celija za svaku celiju (jednom po rasporedu sale i vrata)
+    void buildRoutes(const HallNavigation& nav) {
+        int n = nav.grid.cellCount();
+        nearest.assign(n, 0);
+        nextCell.assign(n, -1);
+        for (int c = 0; c < n; c++) {
+            uint32_t best = FLOW_INF;
+            for (size_t d = 0; d < nav.doors.size(); d++) {
+                if (nav.doors[d].dist[c] < best) {
+                    best = nav.doors[d].dist[c];
+                    nearest[c] = (uint8_t)d;
+                }
+            }
+            if (best != FLOW_INF) nextCell[c] = nav.doors[nearest[c]].next(nav.grid, c);
+            else nearest[c] = EVAC_NO_DOOR;
+        }
+    }
+
+    // Sledeca celija ka najblizim vratima (-1 na vratima ili bez puta)
+    int nextOf(int cell) const { return nextCell[cell]; }
+
+    // Svi sa svojih sedista odjednom; vraca ukupno vreme evakuacije
+    float run(const std::vector<Seat>& seats, const HallNavigation& nav, std::vector<Door>& doors, const CounterRng& rng, uint64_t counter) {
+        const NavGrid& grid = nav.grid;
+        int cells = grid.cellCount();
+        if ((int)nearest.size() != cells) buildRoutes(nav);
+
+        for (Door& d : doors) d.resetStats();
+        occupancy.assign(cells, 0);
+        waiters.assign(cells, -1);
+        cellWait.assign(cells, 0.0f);
+        doorWaiters.assign(doors.size(), -1);
+        agents.clear();
+        active.clear();
+        totalTime = time90 = 0.0f;
+        evacuated = stranded = ticks = 0;
+        agentSteps = 0;
+
+        for (int i = 0; i < (int)seats.size(); i++) {
+            int cell = nav.seatCell(i);
+            if (nearest[cell] == EVAC_NO_DOOR) {
+                stranded++;
+                continue;
+            }
+            Agent a;
+            a.cell = cell;
+            a.budget = 0.0f;
+            a.speed = 0.3f + 0.3f * rng.uniform(RNG_STREAM_AGENT + i, counter);
+            a.stamp = -1;
+            a.nextWaiter = -1;
+            a.waitingSince = 0.0f;
+            agents.push_back(a);
+            occupancy[cell]++;
+        }
+        // Prvo oni najblizi vratima: oslobadjaju celije pre nego sto ih oni iza pokusaju da zauzmu
+        for (int i = 0; i < (int)agents.size(); i++) active.push_back(i);
+        std::sort(active.begin(), active.end(), [&](int a, int b) {
+            return nav.doors[nearest[agents[a].cell]].dist[agents[a].cell] < nav.doors[nearest[agents[b].cell]].dist[agents[b].cell];
+        });
+
+        int total = (int)agents.size();
+        int target90 = (total * 9 + 9) / 10;
+        float clock = 0.0f;
+        while (evacuated < total) {
+            clock += dt;
+            ticks++;
+
+            // Vrata koja su ponovo slobodna bude onoga ko ceka ispred
+            for (size_t d = 0; d < doors.size(); d++) {
+                if (doorWaiters[d] >= 0 && clock >= doors[d].nextFree) wakeList(doorWaiters[d], clock);
+            }
+            if (active.empty()) {
+                bool anyWaiting = false;
+                for (int w : doorWaiters) anyWaiting = anyWaiting || w >= 0;
+                if (!anyWaiting) break; // ne bi trebalo da se desi (vidi gore)
+                continue;
+            }
+
+            moving.clear();
+            for (size_t k = 0; k < active.size(); k++) {
+                int id = active[k];
+                Agent& a = agents[id];
+                if (a.stamp == ticks) {
+                    moving.push_back(id); // probudjen posle svog koraka u ovom tiku
+                    continue;
+                }
+                a.stamp = ticks;
+                agentSteps++;
+                int result = step(id, grid, doors, clock);
+                if (result == STEP_MOVING) moving.push_back(id);
+                else if (result == STEP_LEFT) {
+                    evacuated++;
+                    if (evacuated == target90) time90 = clock;
+                }
+            }
+            active.swap(moving);
+        }
+        totalTime = clock;
+        return totalTime;
+    }
+
+private:
+    enum StepResult { STEP_MOVING, STEP_PARKED, STEP_LEFT };
+
+    struct Agent {
+        int cell;
+        float budget;      // predjeni put koji jos nije potrosen na prelazak u sledecu celiju
+        float speed;
+        int stamp;         // tik u kome je poslednji put obradjen
+        int nextWaiter;    // sledeci u listi cekanja iste celije (ili vrata)
+        float waitingSince;
+    };
+
+    std::vector<uint8_t> nearest;
+    std::vector<int> nextCell;
+    std::vector<Agent> agents;
+    std::vector<uint16_t> occupancy;
+    std::vector<int> waiters;     // prvi koji ceka da se celija oslobodi (lista kroz Agent::nextWaiter)
+    std::vector<int> doorWaiters;
+    std::vector<int> active, moving;
+
+    int step(int id, const NavGrid& grid, std::vector<Door>& doors, float clock) {
+        Agent& a = agents[id];
+        a.budget += a.speed * dt;
+        for (int guard = 0; guard < 16; guard++) {
+            int next = nextCell[a.cell];
+            if (next < 0) {
+                // Na vratima: prolazi ako su slobodna, inace ceka ispred njih
+                Door& d = doors[nearest[a.cell]];
+                if (clock < d.nextFree) {
+                    park(id, doorWaiters[nearest[a.cell]], clock);
+                    return STEP_PARKED;
+                }
+                d.nextFree = clock + d.headway;
+                d.exited++;
+                d.lastExit = clock;
+                leave(a.cell, clock);
+                return STEP_LEFT;
+            }
+
+            int diff = std::abs(next - a.cell);
+            float len = (diff == 1 || diff == grid.width) ? grid.cellSize : grid.cellSize * 1.41421356f;
+            if (a.budget < len) return STEP_MOVING;
+            if (occupancy[next] >= capacity) {
+                a.budget = len; // posle cekanja krece iz mesta, bez nagomilanog puta
+                park(id, waiters[next], clock);
+                return STEP_PARKED;
+            }
+            occupancy[next]++;
+            leave(a.cell, clock);
+            a.cell = next;
+            a.budget -= len;
+        }
+        return STEP_MOVING;
+    }
+
+    void park(int id, int& head, float clock) {
+        Agent& a = agents[id];
+        a.waitingSince = clock;
+        a.nextWaiter = head;
+        head = id;
+    }
+
+    // Covek napusta celiju: ako je tako ispod kapaciteta, svi koji cekaju na nju ponovo su aktivni
+    void leave(int cell, float clock) {
+        occupancy[cell]--;
+        if (occupancy[cell] < capacity && waiters[cell] >= 0) wakeList(waiters[cell], clock);
+    }
+
+    void wakeList(int& head, float clock) {
+        for (int id = head; id >= 0;) {
+            Agent& a = agents[id];
+            int next = a.nextWaiter;
+            // Cekanje se pripisuje celiji u kojoj je covek stajao
+            cellWait[a.cell] += clock - a.waitingSince;
+            a.nextWaiter = -1;
+            active.push_back(id); // ako je vec bio obradjen u ovom tiku, stamp ga odlaze za sledeci
+            id = next;
+        }
+        head = -1;
+    }
+};
+
+// Evakuacija bez prozora: seatCount > 0 pravi pravougaonu salu sa toliko sedista (za poredjenje rasporeda),
+// 0 koristi originalnu salu. Ispisuje ukupno vreme, protok po vratima i uska grla.
+int runEvacuation(int seatCount, int doorCount, int capacity, uint64_t seed);
+
+#endif
@@ -0,0 +1,450 @@
+#pragma once
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "SeatManager.h"
+#include "DoorAssignment.h"
+
+// Mreza prohodnosti preko cele scene (NDC od -1 do 1)
+class NavGrid {
+public:
+    int width, height;
+    float cellSize;
+    float originX, originY;
+    std::vector<uint8_t> blocked;
+
+    // Svaka promena prohodnosti dobija broj verzije; polja toka preko ovoga znaju sta da poprave
+    uint32_t version;
+    struct Change { uint32_t version; int cell; };
+    std::vector<Change> changes;
+
+    NavGrid() : width(0), height(0), cellSize(0.0f), originX(-1.0f), originY(-1.0f), version(0) {}
+
+    void init(float cell) {
+        cellSize = cell;
+        width = (int)std::ceil(2.0f / cell);
+        height = width;
+        blocked.assign(width * height, 0);
+        changes.clear();
+        version = 0;
+    }
+
+    int cellCount() const { return width * height; }
+
+    int cellAt(float x, float y) const {
+        int cx = (int)((x - originX) / cellSize);
+        int cy = (int)((y - originY) / cellSize);
+        if (cx < 0) cx = 0;
+        if (cx >= width) cx = width - 1;
+        if (cy < 0) cy = 0;
+        if (cy >= height) cy = height - 1;
+        return cy * width + cx;
+    }
+
+    void cellCenter(int cell, float& x, float& y) const {
+        x = originX + ((cell % width) + 0.5f) * cellSize;
+        y = originY + ((cell / width) + 0.5f) * cellSize;
+    }
+
+    // Prepreka (ili njeno uklanjanje): blokirane su celije ciji je centar u pravougaoniku
+    void setRect(float x, float y, float w, float h, bool isBlocked) {
+        version++;
+        int x0 = std::max(0, (int)std::ceil((x - originX) / cellSize - 0.5f));
+        int x1 = std::min(width - 1, (int)std::floor((x + w - originX) / cellSize - 0.5f));
+        int y0 = std::max(0, (int)std::ceil((y - originY) / cellSize - 0.5f));
+        int y1 = std::min(height - 1, (int)std::floor((y + h - originY) / cellSize - 0.5f));
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int c = cy * width + cx;
+                if (blocked[c] != (isBlocked ? 1 : 0)) {
+                    blocked[c] = isBlocked ? 1 : 0;
+                    changes.push_back({ version, c });
+                }
+            }
+        }
+    }
+
+    // Najbliza prohodna celija (npr. prolaz ispred sedista, posto je samo sediste prepreka).
+    // Trazi se po prstenovima oko celije, pa nema dodatne memorije.
+    int nearestWalkable(int cell) const {
+        if (!blocked[cell]) return cell;
+        int cx = cell % width, cy = cell / width;
+        for (int r = 1; r < std::max(width, height); r++) {
+            for (int oy = -r; oy <= r; oy++) {
+                for (int ox = -r; ox <= r; ox++) {
+                    if (std::abs(ox) != r && std::abs(oy) != r) continue; // samo ivica prstena
+                    int nx = cx + ox, ny = cy + oy;
+                    if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                    if (!blocked[ny * width + nx]) return ny * width + nx;
+                }
+            }
+        }
+        return cell;
+    }
+};
+
+// Nedostizna celija / celija bez smera (vrata, prepreke)
+const uint32_t FLOW_INF = 0xFFFFFFFF;
+const uint8_t FLOW_NO_DIR = 255;
+
+// Polje toka ka jednom cilju (vratima): za svaku celiju rastojanje do vrata i smer sledeceg koraka.
+// Svi agenti koji izlaze kroz ista vrata dele jedno polje, a korak agenta je O(1).
+//
+// Polje je stablo najkracih puteva sa korenom u vratima. Za ulazak se koristi isto stablo u
+// obrnutom smeru: uz Euler obilazak (tin/tout) za svaku celiju se u O(1) zna koje dete vodi
+// ka zadatom sedistu, pa nije potrebno posebno polje za svako sediste.
+//
+// Oznake obilaska ostavljaju prazan prostor (svaka celija zauzima dve), pa popravka posle
+// promene prohodnosti ponovo numerise samo najmanje podstablo koje obuhvata sve promene.
+class FlowField {
+public:
+    int root;
+    std::vector<uint32_t> dist;  // u jedinicama: 10 pravo, 14 dijagonalno
+    std::vector<uint8_t> dir;    // indeks suseda ka vratima (0-7) ili FLOW_NO_DIR
+    std::vector<uint32_t> tin, tout;
+    uint32_t builtVersion;
+
+    // Statistika poslednje izgradnje/popravke
+    int lastRelaxed;
+    int lastRelabeled; // celije kojima je obilazak ponovo numerisan
+
+    FlowField() : root(-1), builtVersion(0), lastRelaxed(0), lastRelabeled(0), stamp(0) {}
+
+    void build(const NavGrid& grid, int goalCell) {
+        root = goalCell;
+        int n = grid.cellCount();
+        touchStamp.clear(); // izgradnja od nule ne prati promene
+        dist.assign(n, FLOW_INF);
+        dir.assign(n, FLOW_NO_DIR);
+        dist[root] = 0;
+        heap = Heap();
+        heap.push(Entry(0, root));
+        lastRelaxed = relax(grid);
+        builtVersion = grid.version;
+        buildEulerTour(grid);
+        touchStamp.assign(n, 0);
+        prevDir.assign(n, FLOW_NO_DIR);
+        stamp = 0;
+    }
+
+    // Popravlja samo deo polja na koji su uticale promene prohodnosti od poslednje izgradnje
+    void update(const NavGrid& grid) {
+        if (builtVersion == grid.version) return;
+        heap = Heap();
+        touched.clear();
+        stamp++;
+
+        // 1. Celije koje su postale prepreke, i sve celije ciji put do vrata prolazi kroz njih
+        std::vector<int> stack;
+        std::vector<int> affected;
+        for (const NavGrid::Change& ch : grid.changes) {
+            if (ch.version <= builtVersion) continue;
+            if (!grid.blocked[ch.cell]) {
+                affected.push_back(ch.cell); // oslobodjena celija - dobija rastojanje od suseda
+
+                // ...a njeni susedi mozda dobijaju kraci dijagonalni put uz njen ugao
+                forAllNeighbors(grid, ch.cell, [&](int nb, int) {
+                    if (dist[nb] != FLOW_INF) heap.push(Entry(dist[nb], nb));
+                });
+                continue;
+            }
+            invalidate(ch.cell, stack);
+
+            // Nova prepreka zatvara i dijagonalne korake koji su isli uz njen ugao
+            forAllNeighbors(grid, ch.cell, [&](int a, int) {
+                if (dir[a] == FLOW_NO_DIR || dir[a] < 4) return;
+                int ax = a % grid.width, ay = a / grid.width;
+                int c1 = ay * grid.width + ax + dx(dir[a]);
+                int c2 = (ay + dy(dir[a])) * grid.width + ax;
+                if (c1 == ch.cell || c2 == ch.cell) invalidate(a, stack);
+            });
+        }
+        while (!stack.empty()) {
+            int p = stack.back();
+            stack.pop_back();
+            affected.push_back(p);
+            forAllNeighbors(grid, p, [&](int nb, int k) {
+                if (dist[nb] != FLOW_INF && dir[nb] == opposite(k)) invalidate(nb, stack);
+            });
+        }
+
+        // 2. Pogodjene celije uzimaju najbolje rastojanje od nepogodjenih suseda
+        for (int c : affected) {
+            if (c == root && !grid.blocked[c]) {
+                // Vrata su ponovo prohodna: stablo raste iz njih
+                touch(c);
+                dist[c] = 0;
+                heap.push(Entry(0, c));
+            }
+            if (grid.blocked[c] || c == root) continue;
+            forNeighbors(grid, c, [&](int nb, int k, uint32_t cost) {
+                if (dist[nb] != FLOW_INF && dist[nb] + cost < dist[c]) {
+                    touch(c);
+                    dist[c] = dist[nb] + cost;
+                    dir[c] = (uint8_t)k;
+                }
+            });
+            if (dist[c] != FLOW_INF) heap.push(Entry(dist[c], c));
+        }
+
+        // 3. Dijkstra samo od granice pogodjenog dela
+        lastRelaxed = relax(grid);
+        builtVersion = grid.version;
+        updateEulerTour(grid);
+    }
+
+    bool reachable(int cell) const { return dist[cell] != FLOW_INF; }
+
+    // Sledeca celija ka vratima (-1 ako smo na vratima ili je celija nedostizna)
+    int next(const NavGrid& grid, int cell) const {
+        if (dir[cell] == FLOW_NO_DIR) return -1;
+        return neighbor(grid, cell, dir[cell]);
+    }
+
+    // Sledeca celija od "cell" ka "goal" (obrnuto stablo): dete celije cell ciji podstablo sadrzi goal
+    int nextToward(const NavGrid& grid, int cell, int goal) const {
+        if (cell == goal || dist[goal] == FLOW_INF) return -1;
+        int found = -1;
+        forNeighbors(grid, cell, [&](int nb, int k, uint32_t) {
+            if (found < 0 && dir[nb] == opposite(k) && tin[nb] <= tin[goal] && tin[goal] < tout[nb]) found = nb;
+        });
+        return found;
+    }
+
+    // Jedinicni koraci za 8 suseda; prva cetiri su prava
+    static int dx(int k) { static const int v[8] = { 1, -1, 0, 0, 1, -1, 1, -1 }; return v[k]; }
+    static int dy(int k) { static const int v[8] = { 0, 0, 1, -1, 1, -1, -1, 1 }; return v[k]; }
+    static uint8_t opposite(int k) { static const uint8_t v[8] = { 1, 0, 3, 2, 5, 4, 7, 6 }; return v[k]; }
+
+private:
+    typedef std::pair<uint32_t, int> Entry;
+    typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > Heap;
+    Heap heap;
+
+    // Celije cije je stanje menjano u tekucoj popravci, sa smerom koji su imale pre nje
+    std::vector<uint32_t> touchStamp;
+    std::vector<uint8_t> prevDir;
+    std::vector<int> touched;
+    uint32_t stamp;
+
+    static int neighbor(const NavGrid& grid, int cell, int k) {
+        return cell + dy(k) * grid.width + dx(k);
+    }
+
+    void touch(int cell) {
+        if (touchStamp[cell] == stamp) return;
+        touchStamp[cell] = stamp;
+        prevDir[cell] = dir[cell];
+        touched.push_back(cell);
+    }
+
+    // Stablo pre popravke: smer i pripadnost (koren nema smer, a ostale dostizne celije ga imaju)
+    uint8_t oldDir(int cell) const { return touchStamp[cell] == stamp ? prevDir[cell] : dir[cell]; }
+    bool wasInTree(int cell) const { return cell == root || oldDir(cell) != FLOW_NO_DIR; }
+
+    void invalidate(int cell, std::vector<int>& stack) {
+        if (dist[cell] == FLOW_INF) return;
+        touch(cell);
+        dist[cell] = FLOW_INF;
+        dir[cell] = FLOW_NO_DIR;
+        stack.push_back(cell);
+    }
+
+    // Svi susedi u granicama mreze, bez obzira na prepreke
+    template <typename F>
+    static void forAllNeighbors(const NavGrid& grid, int cell, F fn) {
+        int cx = cell % grid.width, cy = cell / grid.width;
+        for (int k = 0; k < 8; k++) {
+            int nx = cx + dx(k), ny = cy + dy(k);
+            if (nx < 0 || ny < 0 || nx >= grid.width || ny >= grid.height) continue;
+            fn(ny * grid.width + nx, k);
+        }
+    }
+
+    // Dijagonalni korak je dozvoljen samo ako nijedna od dve prave celije nije prepreka (bez secenja uglova)
+    template <typename F>
+    static void forNeighbors(const NavGrid& grid, int cell, F fn) {
+        int cx = cell % grid.width, cy = cell / grid.width;
+        for (int k = 0; k < 8; k++) {
+            int nx = cx + dx(k), ny = cy + dy(k);
+            if (nx < 0 || ny < 0 || nx >= grid.width || ny >= grid.height) continue;
+            int nb = ny * grid.width + nx;
+            if (grid.blocked[nb]) continue;
+            if (k >= 4 && (grid.blocked[cy * grid.width + nx] || grid.blocked[ny * grid.width + cx])) continue;
+            fn(nb, k, k < 4 ? 10u : 14u);
+        }
+    }
+
+    int relax(const NavGrid& grid) {
+        int relaxed = 0;
+        while (!heap.empty()) {
+            Entry e = heap.top();
+            heap.pop();
+            if (e.first != dist[e.second]) continue; // zastareo unos
+            relaxed++;
+            int c = e.second;
+            forNeighbors(grid, c, [&](int nb, int k, uint32_t cost) {
+                uint32_t nd = e.first + cost;
+                if (nd < dist[nb]) {
+                    if (!touchStamp.empty()) touch(nb);
+                    dist[nb] = nd;
+                    dir[nb] = opposite(k);
+                    heap.push(Entry(nd, nb));
+                }
+            });
+        }
+        return relaxed;
+    }
+
+    void buildEulerTour(const NavGrid& grid) {
+        int n = grid.cellCount();
+        tin.assign(n, FLOW_INF);
+        tout.assign(n, FLOW_INF);
+        lastRelabeled = labelSubtree(grid, root, 0, 2);
+    }
+
+    // Posle popravke se menjaju samo oznake podstabla A koje pre i posle sadrzi iste celije
+    // (osim onih koje su postale prepreke ili nedostizne): A je zajednicki predak starih i novih
+    // roditelja svih celija cije je mesto u stablu promenjeno. Njegov interval [tin, tout) ostaje
+    // isti, pa oznake ostatka stabla vaze i dalje.
+    void updateEulerTour(const NavGrid& grid) {
+        if (touchStamp[root] == stamp) {
+            buildEulerTour(grid); // promenjena su sama vrata
+            return;
+        }
+        int a = -1;
+        auto include = [&](int c) {
+            if (a < 0) a = c;
+            else while (!(tin[a] <= tin[c] && tin[c] < tout[a])) a = neighbor(grid, a, oldDir(a));
+        };
+        for (int c : touched) {
+            bool was = wasInTree(c), is = dist[c] != FLOW_INF;
+            if (was == is && (!is || prevDir[c] == dir[c])) continue; // isti roditelj
+            if (was) include(neighbor(grid, c, prevDir[c]));
+            if (is) {
+                int parent = neighbor(grid, c, dir[c]);
+                if (wasInTree(parent)) include(parent); // novi roditelj koji nije bio u stablu ima svoj unos
+            }
+        }
+        lastRelabeled = 0;
+        if (a < 0) return;
+
+        for (int c : touched) {
+            if (dist[c] == FLOW_INF) tin[c] = tout[c] = FLOW_INF;
+        }
+
+        // Podstablo koje je poraslo mora da stane u svoj interval: prvo sa razmakom, pa gusto,
+        // pa se ide ka korenu (prepisane oznake pripadaju vecem podstablu, koje se numerise iznova)
+        int stride = 2;
+        uint32_t begin = tin[a], end = tout[a];
+        while (a != root) {
+            lastRelabeled = labelSubtree(grid, a, begin, stride);
+            if (tout[a] <= end) {
+                tout[a] = end;
+                return;
+            }
+            if (stride == 2 && (uint32_t)lastRelabeled <= end - begin) stride = 1;
+            else {
+                a = neighbor(grid, a, dir[a]);
+                begin = tin[a];
+                end = tout[a];
+                stride = 2;
+            }
+        }
+        buildEulerTour(grid);
+    }
+
+    // Iterativni DFS po podstablu; svaka celija zauzima "stride" oznaka. Vraca broj celija.
+    int labelSubtree(const NavGrid& grid, int start, uint32_t t, int stride) {
+        int count = 0;
+        std::vector<std::pair<int, int> > stack;
+        tin[start] = t;
+        t += stride;
+        stack.push_back(std::make_pair(start, 0));
+        while (!stack.empty()) {
+            int c = stack.back().first;
+            int& k = stack.back().second;
+            int cx = c % grid.width, cy = c / grid.width;
+            bool descended = false;
+            while (k < 8) {
+                int kk = k++;
+                int nx = cx + dx(kk), ny = cy + dy(kk);
+                if (nx < 0 || ny < 0 || nx >= grid.width || ny >= grid.height) continue;
+                int nb = ny * grid.width + nx;
+                if (dist[nb] != FLOW_INF && dir[nb] == opposite(kk)) {
+                    tin[nb] = t;
+                    t += stride;
+                    stack.push_back(std::make_pair(nb, 0));
+                    descended = true;
+                    break;
+                }
+            }
+            if (!descended) {
+                tout[c] = t;
+                stack.pop_back();
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+// Navigacija za celu salu: mreza sa sedistima i platnom kao preprekama + po jedno polje toka od svakih vrata
+class HallNavigation {
+public:
+    NavGrid grid;
+    std::vector<FlowField> doors;
+
+    void build(const std::vector<Seat>& seats, const std::vector<Door>& doorList, float cell = 0.02f) {
+        grid.init(cell);
+        for (const Seat& s : seats) grid.setRect(s.x, s.y, s.width, s.height, true);
+        grid.setRect(-0.6f, 0.6f, 1.2f, 0.3f, true); // platno
+
+        doors.resize(doorList.size());
+        for (size_t d = 0; d < doorList.size(); d++) {
+            doors[d].build(grid, grid.nearestWalkable(grid.cellAt(doorList[d].x, doorList[d].y)));
+        }
+        grid.changes.clear();
+
+        seatCenters.resize(seats.size());
+        for (size_t i = 0; i < seats.size(); i++) seatCenters[i] = grid.cellAt(seats[i].x + seats[i].width * 0.5f, seats[i].y + seats[i].height * 0.5f);
+        refreshSeatCells();
+    }
+
+    // Promena rasporeda (npr. zatvoren prolaz): polja se popravljaju samo gde je potrebno.
+    // Prilaz sedistu se ponovo trazi, pa PersonManager::refreshSeatCells treba pozvati posle ovoga.
+    void setObstacle(float x, float y, float w, float h, bool isBlocked) {
+        grid.setRect(x, y, w, h, isBlocked);
+        for (FlowField& f : doors) f.update(grid);
+        grid.changes.clear();
+        refreshSeatCells();
+    }
+
+    // Celija iz koje se prilazi sedistu (samo sediste je prepreka)
+    int seatCell(int seatIndex) const { return seatCells[seatIndex]; }
+
+    // Duzina puta (NDC) od vrata do celije sedista; -1 ako sediste nije dostupno sa tih vrata
+    float pathLength(int seatIndex, int door) const {
+        uint32_t d = doors[door].dist[seatCells[seatIndex]];
+        if (d == FLOW_INF) return -1.0f;
+        return d * 0.1f * grid.cellSize;
+    }
+
+private:
+    std::vector<int> seatCenters; // celija centra sedista
+    std::vector<int> seatCells;
+
+    void refreshSeatCells() {
+        seatCells.resize(seatCenters.size());
+        for (size_t i = 0; i < seatCenters.size(); i++) seatCells[i] = grid.nearestWalkable(seatCenters[i]);
+    }
+};
+
+#endif
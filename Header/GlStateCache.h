@@ -0,0 +1,153 @@
+#pragma once
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+enum GlStateKind {
+    GL_STATE_PROGRAM,
+    GL_STATE_VAO,
+    GL_STATE_BUFFER,
+    GL_STATE_TEXTURE,   // aktivna jedinica i vezana tekstura
+    GL_STATE_BLEND,
+    GL_STATE_UNIFORM,
+    GL_STATE_KIND_COUNT
+};
+
+const unsigned int GL_STATE_UNKNOWN = 0xffffffffu; // stanje koje cache ne zna (posle invalidate)
+
+// Brojaci poziva koji su stigli do drajvera i onih koji su preskoceni (stanje je vec bilo takvo)
+struct GlStateCounters {
+    uint64_t issued[GL_STATE_KIND_COUNT] = {};
+    uint64_t skipped[GL_STATE_KIND_COUNT] = {};
+
+    uint64_t totalIssued() const {
+        uint64_t n = 0;
+        for (int i = 0; i < GL_STATE_KIND_COUNT; i++) n += issued[i];
+        return n;
+    }
+
+    uint64_t totalSkipped() const {
+        uint64_t n = 0;
+        for (int i = 0; i < GL_STATE_KIND_COUNT; i++) n += skipped[i];
+        return n;
+    }
+};
+
+// Tanak sloj izmedju crtanja i GL-a: pamti poslednje postavljeno stanje (program, VAO, bafer,
+// tekstura, mesanje, uniforme) i poziva GL samo kada se nesto stvarno menja.
+// Sve sto crta u frejmu treba da ide kroz isti cache; posle GL poziva mimo njega (npr. pri
+// inicijalizaciji) poziva se invalidate().
+class GlStateCache {
+public:
+    GlStateCounters counters;
+
+    GlStateCache() { invalidate(); }
+
+    // Nista nije poznato: sledeci poziv svake vrste sigurno ide do GL-a
+    void invalidate() {
+        program = vao = arrayBuffer = GL_STATE_UNKNOWN;
+        activeUnit = GL_STATE_UNKNOWN;
+        for (int i = 0; i < TEXTURE_UNITS; i++) textures[i] = GL_STATE_UNKNOWN;
+        blend = -1;
+        uniforms.clear();
+    }
+
+    void useProgram(unsigned int p) {
+        if (!changed(program, p, GL_STATE_PROGRAM)) return;
+        glUseProgram(p);
+        uniforms.clear(); // uniforme su stanje programa
+    }
+
+    void bindVertexArray(unsigned int v) {
+        if (changed(vao, v, GL_STATE_VAO)) glBindVertexArray(v);
+    }
+
+    void bindArrayBuffer(unsigned int b) {
+        if (changed(arrayBuffer, b, GL_STATE_BUFFER)) glBindBuffer(GL_ARRAY_BUFFER, b);
+    }
+
+    void bindTexture(unsigned int unit, unsigned int texture) {
+        if (unit >= TEXTURE_UNITS) return;
+        if (textures[unit] == texture) {
+            counters.skipped[GL_STATE_TEXTURE]++;
+            return;
+        }
+        if (changed(activeUnit, unit, GL_STATE_TEXTURE)) glActiveTexture(GL_TEXTURE0 + unit);
+        counters.issued[GL_STATE_TEXTURE]++;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        textures[unit] = texture;
+    }
+
+    void setBlend(bool on) {
+        if (blend == (on ? 1 : 0)) {
+            counters.skipped[GL_STATE_BLEND]++;
+            return;
+        }
+        counters.issued[GL_STATE_BLEND]++;
+        if (on) glEnable(GL_BLEND);
+        else glDisable(GL_BLEND);
+        blend = on ? 1 : 0;
+    }
+
+    void uniform1i(int loc, int v) {
+        float value[4] = { (float)v, 0.0f, 0.0f, 0.0f };
+        if (uniformChanged(loc, value)) glUniform1i(loc, v);
+    }
+
+    void uniform2f(int loc, float x, float y) {
+        float value[4] = { x, y, 0.0f, 0.0f };
+        if (uniformChanged(loc, value)) glUniform2f(loc, x, y);
+    }
+
+    void uniform4f(int loc, float x, float y, float z, float w) {
+        float value[4] = { x, y, z, w };
+        if (uniformChanged(loc, value)) glUniform4f(loc, x, y, z, w);
+    }
+
+private:
+    enum { TEXTURE_UNITS = 16 };
+
+    struct UniformValue {
+        bool known;
+        float v[4];
+    };
+
+    unsigned int program, vao, arrayBuffer;
+    unsigned int activeUnit;
+    unsigned int textures[TEXTURE_UNITS];
+    int blend; // -1 nepoznato
+    std::vector<UniformValue> uniforms; // po lokaciji, za trenutni program
+
+    bool changed(unsigned int& current, unsigned int value, GlStateKind kind) {
+        if (current == value) {
+            counters.skipped[kind]++;
+            return false;
+        }
+        counters.issued[kind]++;
+        current = value;
+        return true;
+    }
+
+    // Lokacija -1 (uniforma ne postoji ili je izbacena) se ne salje uopste
+    bool uniformChanged(int loc, const float value[4]) {
+        if (loc < 0) {
+            counters.skipped[GL_STATE_UNIFORM]++;
+            return false;
+        }
+        if ((size_t)loc >= uniforms.size()) uniforms.resize(loc + 1, UniformValue{ false, { 0.0f, 0.0f, 0.0f, 0.0f } });
+        UniformValue& u = uniforms[loc];
+        if (u.known && u.v[0] == value[0] && u.v[1] == value[1] && u.v[2] == value[2] && u.v[3] == value[3]) {
+            counters.skipped[GL_STATE_UNIFORM]++;
+            return false;
+        }
+        counters.issued[GL_STATE_UNIFORM]++;
+        u.known = true;
+        for (int i = 0; i < 4; i++) u.v[i] = value[i];
+        return true;
+    }
+};
+
+#endif
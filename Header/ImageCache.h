@@ -0,0 +1,28 @@
+#pragma once
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+// Kes dekodiranih slika na disku: posle prvog pokretanja slike se citaju kao gotovi pikseli,
+// bez stb_image dekodiranja. Zapis je kljucan hesom sadrzaja slike i parametrima ucitavanja
+// (broj kanala, obrnuto ili ne); hes se ne racuna ponovo dok su velicina i vreme izmene
+// slike isti kao pri poslednjem citanju (indeks u direktorijumu kesa).
+struct ImageCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    double hitTime = 0.0;      // sekunde ucitavanja iz kesa
+    double decodeTime = 0.0;   // sekunde dekodiranja pri promasajima
+    double savedTime = 0.0;    // dekodiranje koje je kes ustedeo (po vremenu zapisanom u kesu) minus hitTime
+};
+
+// Prazan direktorijum iskljucuje kes (slike se samo dekodiraju)
+void imageCacheSetDirectory(const std::string& directory);
+ImageCacheStats imageCacheStats();
+
+// Kao stbi_load (desiredChannels 0 = kanali slike), uz opciono obrtanje po vertikali.
+// Vraca piksele koji se oslobadjaju sa stbi_image_free; NULL ako slika ne moze da se ucita.
+unsigned char* loadImageCached(const char* filePath, int* width, int* height, int* channels, int desiredChannels, bool flip);
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ArrivalSchedule.h"
+#include "CrowdLod.h"
+
+class SeatManager;
+class PersonManager;
+class CinemaSimulator;
+
+// Ulaz korisnika kao dogadjaji: isti put za zivi unos (GLFW) i za reprodukciju snimka
+enum InputEventType {
+    INPUT_CLICK = 1, // klik na (x, y) u NDC
+    INPUT_BUY = 2,   // taster 1-9: kupovina n susednih sedista
+    INPUT_START = 3  // Enter: pocetak projekcije
+};
+
+struct InputEvent {
+    uint8_t type;
+    uint8_t count;
+    float x, y;
+};
+
+// Podesavanja koja menjaju tok simulacije; snimak ih nosi sa sobom
+struct ReplayConfig {
+    uint64_t seed;
+    int doorCount;
+    bool flowField;
+    bool compact;
+    ArrivalSchedule arrivals;
+    bool lod;                          // nivo detalja (vec iskljucen ako se koristi polje toka)
+    FocusRect focus;
+    std::vector<uint8_t> initialSeats; // stanje svakog sedista na pocetku snimanja
+};
+
+// Snimak sesije: zaglavlje (seme, podesavanja, raspored dolazaka, fokus nivoa detalja, pocetno stanje sala), pa za svaki frejm
+// njegov dt i ulaz tog frejma. Na kraju je hes stanja simulacije, da reprodukcija proveri
+// da je dosla do potpuno istog stanja.
+//
+// Zapisi: FRAME (1 + 4 bajta), CLICK (1 + 8), BUY (1 + 1), START (1), END (1 + 8 + 4).
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const std::string& path, const ReplayConfig& config);
+    bool isOpen() const { return file != NULL; }
+
+    // Novi frejm; dt se cuva kao float, pa pozivalac treba da simulira sa (float)dt
+    void frame(float dt, const std::vector<InputEvent>& events);
+
+    // Zatvara snimak i upisuje hes krajnjeg stanja
+    void close(uint64_t finalHash);
+
+    uint32_t frames = 0;
+
+private:
+    FILE* file;
+};
+
+class InputReplay {
+public:
+    ReplayConfig config;
+    uint32_t frames = 0;
+
+    // Hes krajnjeg stanja iz snimka (ako je snimanje uredno zavrseno)
+    bool hasFinalHash = false;
+    uint64_t finalHash = 0;
+
+    InputReplay();
+    ~InputReplay();
+
+    bool open(const std::string& path);
+    bool isOpen() const { return file != NULL; }
+    void close();
+
+    // Sledeci frejm iz snimka; false na kraju
+    bool nextFrame(float& dt, std::vector<InputEvent>& events);
+
+private:
+    FILE* file;
+    bool pending; // procitan je tip sledeceg zapisa (FRAME) ali ne i sam frejm
+};
+
+// Hes stanja simulacije (sedista, ljudi, faza, boje platna) - za poredjenje snimka i reprodukcije
+uint64_t simulationHash(const SeatManager& sm, const PersonManager& pm, const CinemaSimulator& sim);
+
+// Reprodukcija bez prozora, najvecom brzinom: proverava hes i meri frejmove u sekundi
+int runHeadlessReplay(const std::string& path);
+
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include <cstdint>
+#include "ArrivalSchedule.h"
+
+// Statisticka procena "koliko traje punjenje i praznjenje sale pri popunjenosti Y":
+// mnogo ciklusa ulazak/izlazak bez prozora, paralelno, dok interval poverenja ne postane dovoljno uzak.
+struct MonteCarloConfig {
+    double occupancy = 1.0;     // udeo prodatih sedista (0..1)
+    float minTurnout = 1.0f;    // najmanji udeo kupaca koji dodje; 1 = svi (popunjenost je tacno occupancy), 0.5 = kao u simulaciji
+    int doorCount = 1;
+    bool flowField = false;
+    bool compact = false;
+    ArrivalSchedule arrivals;   // postepen dolazak: ciklus pocinje otvaranjem vrata, ne dolaskom prvog coveka
+    uint64_t seed = 0;
+    int threads = 0;            // 0 = broj jezgara
+    double precision = 0.01;    // trazeni poluprecnik intervala, relativno u odnosu na srednju vrednost
+    double z = 1.96;            // 95% interval poverenja
+    int minCycles = 30;
+    int maxCycles = 100000;
+    double dt = 1.0 / 75.0;     // korak kao u glavnoj petlji
+};
+
+// Ispisuje srednje vreme, interval poverenja i kvantile za ulazak i izlazak; ciklusi su odredjeni semenom,
+// pa isto seme daje iste brojeve bez obzira na broj niti
+int runMonteCarlo(const MonteCarloConfig& config);
+
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Skladiste objekata koje se ponovo koristi iz ciklusa u ciklus (npr. ljudi u sali za svaku projekciju).
+//
+// Indeks objekta je stabilan dok je ziv, a oslobodjeni slotovi idu na listu slobodnih i prvi se
+// ponovo dodeljuju. Kada je kapacitet jednom dovoljan (reserve), acquire/release/releaseAll ne
+// alociraju nista - memorija raste samo kada zivih objekata ima vise nego ikad ranije.
+template <typename T>
+class ObjectPool {
+public:
+    // Koliko puta je skladiste moralo da raste (svaki rast je alokacija)
+    uint64_t growths = 0;
+
+    void reserve(size_t n) {
+        if (n <= items.size()) return;
+        size_t old = items.size();
+        items.resize(n);
+        alive.resize(n, 0);
+        freeList.reserve(n);
+        // Slobodni slotovi se uzimaju sa kraja liste, pa ih ubacujemo unazad: prvo se dodeljuje najmanji indeks
+        for (size_t i = n; i > old; i--) freeList.push_back((int)(i - 1));
+        growths++;
+    }
+
+    // Novi ziv objekat; vraca njegov indeks
+    int acquire() {
+        if (freeList.empty()) {
+            // Udvostrucavanje, bez obzira sto freeList vec ima prostor
+            reserve(items.empty() ? 16 : items.size() * 2);
+        }
+        int i = freeList.back();
+        freeList.pop_back();
+        alive[i] = 1;
+        live++;
+        return i;
+    }
+
+    void release(int i) {
+        if (!alive[i]) return;
+        alive[i] = 0;
+        live--;
+        freeList.push_back(i);
+    }
+
+    // Oslobadja sve; sledeci acquire ponovo krece od indeksa 0 (gusto pakovani zivi objekti)
+    void releaseAll() {
+        freeList.clear();
+        for (size_t i = items.size(); i > 0; i--) {
+            alive[i - 1] = 0;
+            freeList.push_back((int)(i - 1));
+        }
+        live = 0;
+    }
+
+    T& operator[](int i) { return items[i]; }
+    const T& operator[](int i) const { return items[i]; }
+    bool isAlive(int i) const { return alive[i] != 0; }
+
+    size_t size() const { return live; }
+    bool empty() const { return live == 0; }
+    size_t capacity() const { return items.size(); }
+
+    // Prolaz samo kroz zive objekte: for (T& x : pool)
+    template <typename Pool, typename Ref>
+    class Iter {
+    public:
+        Iter(Pool* p, size_t i) : pool(p), index(i) { skip(); }
+        Ref operator*() const { return pool->items[index]; }
+        typename std::remove_reference<Ref>::type* operator->() const { return &pool->items[index]; }
+        Iter& operator++() { index++; skip(); return *this; }
+        bool operator!=(const Iter& o) const { return index != o.index; }
+        int position() const { return (int)index; }
+
+    private:
+        Pool* pool;
+        size_t index;
+        void skip() { while (index < pool->items.size() && !pool->alive[index]) index++; }
+    };
+    typedef Iter<ObjectPool, T&> iterator;
+    typedef Iter<const ObjectPool, const T&> const_iterator;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, items.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, items.size()); }
+
+private:
+    std::vector<T> items;
+    std::vector<uint8_t> alive;
+    std::vector<int> freeList;
+    size_t live = 0;
+};
+
+#endif
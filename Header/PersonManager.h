@@ -7,8 +7,15 @@
 #include <GLFW/glfw3.h>
 #include <cmath>
 #include <algorithm> 
-#include <random>    
 #include "SeatManager.h"
+#include "FlowField.h"
+#include "ObjectPool.h"
+#include "CompactPerson.h"
+#include "CounterRng.h"
+#include "ArrivalSchedule.h"
+#include "CrowdLod.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
 #include "Util.h"
 
 struct Person {
@@ -20,25 +27,109 @@ struct Person {
     bool seated;
     bool isExiting;
     bool hasLeft;
+
+    // Samo za kretanje po polju toka: trenutna celija mreze i celija iz koje se prilazi sedistu
+    int navCell;
+    int goalCell;
+
+    int seatIndex;
+    int door;   // vrata kroz koja ulazi/izlazi
+    float wait; // ulazak: koliko jos ceka red na vratima (< 0 kada je prosao kroz vrata)
 };
 
+// Zakazan dolazak: covek postoji (u skladistu) tek od trenutka kada stigne pred vrata
+struct ArrivalEvent {
+    float time;
+    int seat;
+    float speed;
+    float targetX, targetY;
+};
+
+// Za std::*_heap: na vrhu je najraniji dolazak
+inline bool laterArrival(const ArrivalEvent& a, const ArrivalEvent& b) {
+    return a.time > b.time || (a.time == b.time && a.seat > b.seat);
+}
+
 class PersonManager {
 public:
-    std::vector<Person> people;
-    unsigned int personTexture;
+    // Ljudi se ne alociraju za svaku projekciju: slotovi se vracaju u skladiste i ponovo koriste
+    ObjectPool<Person> people;
+    Sprite personSprite;
+
+    // Opciono: sazet zapis (CompactPerson) za ogromne sale - isto kretanje, ~2.5x manje memorije po coveku
+    bool compact;
+    ObjectPool<CompactPerson> compactPeople;
+
+    // Opciono: kretanje po polju toka (prolazi, prepreke) umesto putanje "vertikalno pa horizontalno"
+    HallNavigation* nav;
+
+    // Vrata sale (podrazumevano jedna, gore levo) i rasporedjivanje ljudi po vratima
+    std::vector<Door> doors;
+    DoorAssigner assigner;
+
+    // Vreme od pocetka trenutne faze (ulazak ili izlazak)
+    float clock;
+
+    // Koliko ljudi se posle poslednjeg koraka jos krece (ili ceka na vratima)
+    size_t moving;
+
+    // Slucajnost je odredjena semenom i brojem projekcije (isto seme = isti ljudi i brzine)
+    CounterRng rng;
+    uint64_t projection;
 
-    PersonManager() {
-        personTexture = loadImageToTexture("person.png");
-        if (personTexture == 0) {
+    // Raspored dolazaka; podrazumevano su svi pred vratima cim pocne projekcija
+    ArrivalSchedule arrivals;
+
+    // Najmanji udeo kupaca koji dodje na projekciju: dolazi slucajan broj izmedju toga i svih
+    float minTurnout;
+
+    // Opciono: nivo detalja (samo uz osnovnu putanju, bez polja toka). Pojedinacno se simuliraju
+    // samo ljudi u fokusu; ostali su zbirni, bez koraka po tiku, i crtaju se kao gustina.
+    bool lod;
+    FocusRect focus;
+    DensityGrid density;
+    int densityBudget = 4096;   // najvise ovoliko zbirnih ljudi po tiku se premesta u mrezi gustine
+    int lodEventBudget = 8192;  // najvise ovoliko dogadjaja zbirnih ljudi po tiku; ostali cekaju sledeci tik
+    int exitBudget = 4096;      // pri izlasku se po tiku ustaje i rasporedjuje po vratima najvise ovoliko zbirnih
+    ObjectPool<LodAgent> lodAgents;
+    size_t lodMoving;           // zbirni koji jos nisu stigli na kraj putanje
+
+    // loadTexture = false za rad bez prozora (merenja, simulacije bez crtanja)
+    PersonManager(bool loadTexture = true) {
+        nav = NULL;
+        compact = false;
+        minTurnout = 0.5f;
+        lod = false;
+        lodMoving = 0;
+        densityCursor = 0;
+        exitCursor = 0;
+        exitPending = false;
+        density.init(64);
+        clock = 0.0f;
+        moving = 0;
+        projection = 0;
+        doors.push_back(Door());
+        if (!loadTexture) return;
+        personSprite.texture = loadImageToTexture("person.png");
+        if (personSprite.texture == 0) {
             std::cout << "GRESKA: 'person.png' nije nadjen." << std::endl;
         }
     }
 
     void spawnPeople(const SeatManager& sm) {
-        people.clear();
-        std::vector<int> occupiedIndices;
-        for (int i = 0; i < sm.seats.size(); i++) {
-            if (sm.seats[i].state == RESERVED || sm.seats[i].state == SOLD) {
+        spawnPeople(sm.seats);
+    }
+
+    // Prima niz sedista (npr. nepromenljiv snimak sale), ne mora da bude ziv SeatManager
+    void spawnPeople(const std::vector<Seat>& seats) {
+        clear();
+        projection++; // svaka projekcija dobija nove slucajne brojeve
+        if (compact) compactPeople.reserve(seats.size());
+        else people.reserve(seats.size()); // samo prvi put (ili za vecu salu) stvarno alocira
+        occupiedIndices.clear();
+        occupiedIndices.reserve(seats.size());
+        for (int i = 0; i < (int)seats.size(); i++) {
+            if (seats[i].state == RESERVED || seats[i].state == SOLD) {
                 occupiedIndices.push_back(i);
             }
         }
@@ -46,96 +137,496 @@ public:
         if (occupiedIndices.empty()) return; // Niko ne ulazi
 
         int maxPeople = occupiedIndices.size();
-        int minPeople = (maxPeople > 1) ? maxPeople / 2 : 1;
-        int peopleCount = minPeople + rand() % (maxPeople - minPeople + 1);
+        int minPeople = (int)(maxPeople * minTurnout);
+        if (minPeople < 1) minPeople = 1;
+        int peopleCount = minPeople + (int)rng.below(maxPeople - minPeople + 1, RNG_STREAM_SPAWN, projection);
+
+        // Delimicni Fisher-Yates: samo prvih peopleCount mesta nam treba
+        for (int i = 0; i < peopleCount; i++) {
+            int j = i + (int)rng.below(maxPeople - i, RNG_STREAM_SPAWN, projection, i + 1);
+            std::swap(occupiedIndices[i], occupiedIndices[j]);
+        }
 
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(occupiedIndices.begin(), occupiedIndices.end(), g);
+        // Izabrana sedista redom: ljudi u skladistu prate raspored sedista, pa tabela ciljeva
+        // (i mreza polja toka) se citaju redom, a ne nasumicno
+        std::sort(occupiedIndices.begin(), occupiedIndices.begin() + peopleCount);
 
-        float startX = -0.98f;
-        float startY = 0.6f;
+        seatTargets.resize(seats.size());
+        for (size_t i = 0; i < seats.size(); i++) {
+            seatTargets[i].x = toFixedPos(seats[i].x);
+            seatTargets[i].y = toFixedPos(seats[i].y);
+            seatTargets[i].cell = nav ? nav->seatCell((int)i) : -1;
+        }
 
+        bool staggered = arrivals.mode != ARRIVE_AT_ONCE;
+        if (lod) lodAgents.reserve(peopleCount);
         for (int i = 0; i < peopleCount; i++) {
             int seatIndex = occupiedIndices[i];
-            const Seat& targetSeat = sm.seats[seatIndex];
-
-            Person p;
-            p.x = startX;
-            p.y = startY;
-            p.startX = startX;
-            p.startY = startY;
-            p.targetX = targetSeat.x;
-            p.targetY = targetSeat.y;
-            p.speed = 0.3f + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / 0.3f));
-            p.reachedRow = false;
-            p.seated = false;
-            p.isExiting = false;
-            p.hasLeft = false;
+            float speed = 0.3f + 0.3f * rng.uniform(RNG_STREAM_AGENT + seatIndex, projection);
 
-            people.push_back(p);
+            if (staggered) {
+                ArrivalEvent e;
+                e.time = arrivals.sample(rng, RNG_STREAM_ARRIVAL + seatIndex, projection);
+                e.seat = seatIndex;
+                e.speed = speed;
+                e.targetX = seats[seatIndex].x;
+                e.targetY = seats[seatIndex].y;
+                arrivalQueue.push_back(e);
+                continue;
+            }
+            if (lod) createLod(seatIndex, speed);
+            else createPerson(seatIndex, speed, seats[seatIndex].x, seats[seatIndex].y);
+        }
+
+        if (staggered) {
+            // Dolasci cekaju u redu dogadjaja; update pusta samo one kojima je doslo vreme,
+            // a vrata se biraju tek tada (prema redu koji je u tom trenutku na vratima)
+            std::make_heap(arrivalQueue.begin(), arrivalQueue.end(), laterArrival);
+            clock = 0.0f;
+            for (Door& d : doors) d.resetStats();
+            return;
+        }
+
+        // Ko kroz koja vrata ulazi i kojim redom: red na vratima se pusta jedan po jedan (headway)
+        if (lod) {
+            // Svi krecu kao zbirni; ko je (ili ce biti) u fokusu, postaje pojedinacan kada tamo stigne
+            assignDoors(lodAgents);
+            moving = 0;
+            for (size_t i = 0; i < agents.size(); i++) admitLod(agents[i], slotOf[i] * doors[lodAgents[agents[i]].door].headway);
+            return;
+        }
+        if (compact) {
+            assignDoors(compactPeople);
+            for (size_t i = 0; i < agents.size(); i++) {
+                CompactPerson& c = compactPeople[agents[i]];
+                placeAtDoor(c, c.door, slotOf[i] * doors[c.door].headway);
+            }
+            return;
+        }
+        assignDoors(people);
+        for (size_t i = 0; i < agents.size(); i++) {
+            Person& p = people[agents[i]];
+            placeAtDoor(p, p.door, slotOf[i] * doors[p.door].headway);
+        }
+    }
+
+    // Novi covek u skladistu (jos bez vrata); vraca indeks
+    int createPerson(int seatIndex, float speed, float targetX, float targetY) {
+        if (compact) {
+            int index = compactPeople.acquire();
+            CompactPerson& c = compactPeople[index];
+            c.seat = (uint32_t)seatIndex;
+            c.speed = (uint16_t)(speed * PERSON_SPEED_SCALE);
+            c.flags = (uint8_t)PHASE_ENTERING;
+            return index;
+        }
+
+        int index = people.acquire();
+        Person& p = people[index];
+        p.targetX = targetX;
+        p.targetY = targetY;
+        p.speed = speed;
+        p.reachedRow = false;
+        p.seated = false;
+        p.isExiting = false;
+        p.hasLeft = false;
+        p.goalCell = seatTargets[seatIndex].cell;
+        p.seatIndex = seatIndex;
+        return index;
+    }
+
+    void placeAtDoor(Person& p, int door, float wait) {
+        const Door& d = doors[door];
+        p.door = door;
+        p.x = p.startX = d.x;
+        p.y = p.startY = d.y;
+        p.navCell = nav ? nav->doors[door].root : -1;
+        p.wait = wait;
+    }
+
+    void placeAtDoor(CompactPerson& c, int door, float wait) {
+        const Door& d = doors[door];
+        c.door = (uint8_t)door;
+        c.x = toFixedPos(d.x);
+        c.y = toFixedPos(d.y);
+        c.navCell = nav ? nav->doors[door].root : -1;
+        c.wait = wait;
+    }
+
+    // Pusta sve ciji je dolazak do sada. Svako bira vrata sa najmanjim (red na vratima + put do
+    // sedista) u trenutku dolaska i staje u red: vrata pustaju jednog na svakih headway sekundi.
+    void processArrivals() {
+        while (!arrivalQueue.empty() && arrivalQueue.front().time <= clock) {
+            std::pop_heap(arrivalQueue.begin(), arrivalQueue.end(), laterArrival);
+            ArrivalEvent e = arrivalQueue.back();
+            arrivalQueue.pop_back();
+
+            const SeatTarget& t = seatTargets[e.seat];
+            int best = 0;
+            float bestCost = 0.0f;
+            for (int d = 0; d < (int)doors.size(); d++) {
+                float len = nav ? nav->pathLength(e.seat, d)
+                    : std::fabs(doors[d].y - fromFixedPos(t.y)) + std::fabs(doors[d].x - fromFixedPos(t.x));
+                float cost = (len < 0.0f ? 1e6f : len / e.speed) + std::max(doors[d].nextFree - clock, 0.0f);
+                if (d == 0 || cost < bestCost) {
+                    best = d;
+                    bestCost = cost;
+                }
+            }
+            Door& door = doors[best];
+            float wait = std::max(door.nextFree - clock, 0.0f);
+            door.nextFree = clock + wait + door.headway;
+
+            if (lod) {
+                int id = createLod(e.seat, e.speed);
+                lodAgents[id].door = (uint8_t)best;
+                admitLod(id, clock + wait);
+                continue;
+            }
+            int index = createPerson(e.seat, e.speed, e.targetX, e.targetY);
+            if (compact) placeAtDoor(compactPeople[index], best, wait);
+            else placeAtDoor(people[index], best, wait);
         }
     }
 
+    // Koliko ljudi jos nije stiglo
+    size_t pendingArrivals() const {
+        return arrivalQueue.size();
+    }
+
+    // Bez rada dok se niko ne krece (svi prisutni sede) a sledeci dolazak je tek za nekoliko koraka:
+    // sat se pomera istim koracima kao update (isti rezultat), ali bez prolaza kroz skladiste.
+    // Vraca broj preskocenih koraka.
+    int skipIdle(double deltaTime) {
+        if (arrivalQueue.empty() || moving != 0 || lodMoving != 0) return 0;
+        float dt = (float)deltaTime;
+        float next = arrivalQueue.front().time;
+        int skipped = 0;
+        while (clock + dt < next) {
+            clock += dt;
+            skipped++;
+        }
+        return skipped;
+    }
+
     void startExit() {
+        if (lod) {
+            startLodExit();
+            return;
+        }
+        if (compact) {
+            for (CompactPerson& c : compactPeople) c.flags = (uint8_t)PHASE_EXITING;
+            assignDoors(compactPeople);
+            return;
+        }
+
         for (Person& p : people) {
             p.isExiting = true;
             p.seated = false;
             p.reachedRow = false;
         }
+
+        // Izlazak se ponovo rasporedjuje (od sedista); red se pravi na samim vratima
+        assignDoors(people);
+        for (Person& p : people) {
+            p.startX = doors[p.door].x;
+            p.startY = doors[p.door].y;
+        }
+    }
+
+    // Posle HallNavigation::setObstacle: prilaz sedistu je mozda pomeren (stari je postao prepreka)
+    void refreshSeatCells() {
+        if (nav == NULL) return;
+        for (size_t i = 0; i < seatTargets.size(); i++) seatTargets[i].cell = nav->seatCell((int)i);
+        for (Person& p : people) {
+            if (!p.isExiting) p.goalCell = seatTargets[p.seatIndex].cell;
+        }
+    }
+
+    // Ocekivano vreme puta svakog coveka do svakih vrata, pa rasporedjivanje (put + red na vratima)
+    // (Isto za oba zapisa: cilj se cita iz tabele sedista)
+    template <typename T>
+    void assignDoors(ObjectPool<T>& pool) {
+        clock = 0.0f;
+        for (Door& d : doors) d.resetStats();
+
+        // Indeksi zivih ljudi, redom (posle releaseAll su to 0..n-1)
+        agents.clear();
+        for (typename ObjectPool<T>::iterator it = pool.begin(); it != pool.end(); ++it) agents.push_back(it.position());
+
+        fillTravel(pool);
+        int n = (int)agents.size();
+        assigner.assign(travel, n, doors, doorOf, slotOf);
+        for (int i = 0; i < n; i++) setDoor(pool[agents[i]], doorOf[i]);
+        moving = (size_t)n;
+    }
+
+    // travel[i * brojVrata + d] za ljude iz agents
+    template <typename T>
+    void fillTravel(ObjectPool<T>& pool) {
+        int n = (int)agents.size(), dc = (int)doors.size();
+        travel.resize((size_t)n * dc);
+        for (int i = 0; i < n; i++) {
+            const T& p = pool[agents[i]];
+            const SeatTarget& t = seatTargets[seatOf(p)];
+            for (int d = 0; d < dc; d++) {
+                float len = nav ? nav->pathLength(seatOf(p), d)
+                    : std::fabs(doors[d].y - fromFixedPos(t.y)) + std::fabs(doors[d].x - fromFixedPos(t.x));
+                travel[i * dc + d] = len < 0.0f ? 1e6f : len / speedOf(p);
+            }
+        }
+    }
+
+    static int seatOf(const Person& p) { return p.seatIndex; }
+    static int seatOf(const CompactPerson& c) { return (int)c.seat; }
+    static float speedOf(const Person& p) { return p.speed; }
+    static float speedOf(const CompactPerson& c) { return c.speed / PERSON_SPEED_SCALE; }
+    static void setDoor(Person& p, int door) { p.door = door; }
+    static void setDoor(CompactPerson& c, int door) { c.door = (uint8_t)door; }
+    static int seatOf(const LodAgent& a) { return (int)a.seat; }
+    static float speedOf(const LodAgent& a) { return a.speed; }
+    static void setDoor(LodAgent& a, int door) { a.door = (uint8_t)door; }
+
+    // Sazet zapis se za korak raspakuje u Person (na steku), pomeri istim kodom i ponovo spakuje.
+    // Iz memorije se cita i u nju pise samo 20 bajtova po coveku.
+    void unpack(const CompactPerson& c, Person& p) const {
+        const SeatTarget& t = seatTargets[c.seat];
+        const Door& d = doors[c.door];
+        int phase = c.flags & PERSON_PHASE_MASK;
+        p.x = fromFixedPos(c.x);
+        p.y = fromFixedPos(c.y);
+        p.targetX = fromFixedPos(t.x);
+        p.targetY = fromFixedPos(t.y);
+        p.startX = quantizePos(d.x);
+        p.startY = quantizePos(d.y);
+        p.speed = c.speed / PERSON_SPEED_SCALE;
+        p.reachedRow = (c.flags & PERSON_SECOND_LEG) != 0;
+        p.seated = phase == PHASE_SEATED;
+        p.isExiting = phase >= PHASE_EXITING;
+        p.hasLeft = phase == PHASE_LEFT;
+        p.navCell = c.navCell;
+        p.goalCell = t.cell;
+        p.seatIndex = (int)c.seat;
+        p.door = c.door;
+        p.wait = c.wait;
+    }
+
+    static void pack(const Person& p, CompactPerson& c) {
+        int phase = p.hasLeft ? PHASE_LEFT : p.isExiting ? PHASE_EXITING : p.seated ? PHASE_SEATED : PHASE_ENTERING;
+        c.x = toFixedPos(p.x);
+        c.y = toFixedPos(p.y);
+        c.navCell = p.navCell;
+        c.wait = p.wait;
+        c.flags = (uint8_t)(phase | (p.reachedRow ? PERSON_SECOND_LEG : 0));
     }
 
     void update(double deltaTime) {
         float dt = (float)deltaTime;
+        clock += dt;
+        processArrivals();
+        moving = 0;
+        if (lod) {
+            if (exitPending) continueLodExit();
+            processLodEvents();
+        }
 
-        for (Person& p : people) {
-            if (p.hasLeft) continue;
-
-            if (!p.isExiting) {
-                if (p.seated) continue;
-
-                if (!p.reachedRow) {
-                    if (p.y > p.targetY) {
-                        p.y -= p.speed * dt;
-                        if (p.y <= p.targetY) {
-                            p.y = p.targetY;
-                            p.reachedRow = true;
-                        }
-                    }
-                    else p.reachedRow = true;
+        if (compact) {
+            for (ObjectPool<CompactPerson>::iterator it = compactPeople.begin(); it != compactPeople.end(); ++it) {
+                CompactPerson& c = *it;
+                if ((c.flags & PERSON_PHASE_MASK) == PHASE_SEATED) continue;
+                if (nav) {
+                    // Polje toka: raspakuje se u Person (na steku), pomera istim kodom i ponovo pakuje
+                    Person p;
+                    unpack(c, p);
+                    updatePerson(p, dt);
+                    pack(p, c);
                 }
-                else {
-                    if (p.x < p.targetX) {
-                        p.x += p.speed * dt;
-                        if (p.x >= p.targetX) {
-                            p.x = p.targetX;
-                            p.seated = true;
-                        }
+                else updateCompact(c, dt);
+                int phase = c.flags & PERSON_PHASE_MASK;
+                if (phase == PHASE_LEFT) compactPeople.release(it.position());
+                else if (phase != PHASE_SEATED) {
+                    if (lod && !focus.contains(fromFixedPos(c.x), fromFixedPos(c.y))) {
+                        Person p;
+                        unpack(c, p);
+                        demote(p);
+                        compactPeople.release(it.position());
                     }
-                    else p.seated = true;
+                    else moving++;
                 }
             }
-            else {
-                if (p.x > p.startX) {
-                    p.x -= p.speed * dt;
-                    if (p.x <= p.startX) p.x = p.startX;
-                }
-                else {
-                    if (p.y < p.startY) {
-                        p.y += p.speed * dt;
-                        if (p.y >= p.startY) {
-                            p.y = p.startY;
-                            p.hasLeft = true;
-                        }
-                    }
-                    else p.hasLeft = true;
+            if (lod) refreshDensity();
+            return;
+        }
+
+        for (ObjectPool<Person>::iterator it = people.begin(); it != people.end(); ++it) {
+            Person& p = *it;
+            updatePerson(p, dt);
+            if (p.hasLeft) people.release(it.position()); // izasao - slot se vraca u skladiste
+            else if (p.isExiting || !p.seated) {
+                if (lod && !focus.contains(p.x, p.y)) {
+                    demote(p);
+                    people.release(it.position());
                 }
+                else moving++;
+            }
+        }
+        if (lod) refreshDensity();
+    }
+
+    void updatePerson(Person& p, float dt) {
+        // Ceka svoj red na vratima
+        if (!p.isExiting && p.wait >= 0.0f) {
+            p.wait -= dt;
+            if (p.wait >= 0.0f) return;
+            doors[p.door].entered++;
+            doors[p.door].lastEnter = clock;
+        }
+
+        if (nav) {
+            updateOnFlowField(p, dt);
+            return;
+        }
+
+        float step = p.speed * dt;
+        if (!p.isExiting) {
+            if (p.seated) return;
+
+            // Prvo vertikalno do reda, pa horizontalno do sedista
+            if (!p.reachedRow) {
+                if (moveToward(p.y, p.targetY, step)) p.reachedRow = true;
+            }
+            else {
+                if (moveToward(p.x, p.targetX, step)) p.seated = true;
+            }
+        }
+        else {
+            // Izlazak obrnutim redom: horizontalno do vrata, pa vertikalno
+            if (p.x != p.startX) moveToward(p.x, p.startX, step);
+            else if (moveToward(p.y, p.startY, step)) leaveThroughDoor(p);
+        }
+    }
+
+    // Ista putanja kao u updatePerson (vertikalno pa horizontalno), ali direktno nad 16-bitnim
+    // pozicijama: bez raspakivanja i bez float konverzija pozicija
+    void updateCompact(CompactPerson& c, float dt) {
+        int phase = c.flags & PERSON_PHASE_MASK;
+        if (phase == PHASE_ENTERING && c.wait >= 0.0f) {
+            c.wait -= dt;
+            if (c.wait >= 0.0f) return;
+            doors[c.door].entered++;
+            doors[c.door].lastEnter = clock;
+        }
+
+        int step = (int)(c.speed * dt * (PERSON_POS_SCALE / PERSON_SPEED_SCALE) + 0.5f);
+        if (step < 1) step = 1;
+        bool secondLeg = (c.flags & PERSON_SECOND_LEG) != 0;
+
+        if (phase == PHASE_ENTERING) {
+            const SeatTarget& t = seatTargets[c.seat];
+            if (!secondLeg) {
+                if (moveToward(c.y, t.y, step)) c.flags |= PERSON_SECOND_LEG;
+            }
+            else if (moveToward(c.x, t.x, step)) c.flags = (uint8_t)PHASE_SEATED;
+        }
+        else {
+            int16_t sx = toFixedPos(doors[c.door].x), sy = toFixedPos(doors[c.door].y);
+            if (c.x != sx) moveToward(c.x, sx, step);
+            else if (moveToward(c.y, sy, step) && passDoor(c.door)) c.flags = (uint8_t)PHASE_LEFT;
+        }
+    }
+
+    // Pomera vrednost ka cilju za najvise step; vraca true kada je stigla
+    static bool moveToward(float& v, float target, float step) {
+        if (v < target) v = std::min(v + step, target);
+        else if (v > target) v = std::max(v - step, target);
+        return v == target;
+    }
+
+    static bool moveToward(int16_t& v, int16_t target, int step) {
+        if (v < target) v = (int16_t)std::min(v + step, (int)target);
+        else if (v > target) v = (int16_t)std::max(v - step, (int)target);
+        return v == target;
+    }
+
+    // Vrata propustaju jednog coveka na svakih headway sekundi, ostali cekaju ispred
+    bool passDoor(int door) {
+        Door& d = doors[door];
+        if (clock < d.nextFree) return false;
+        d.nextFree = clock + d.headway;
+        d.exited++;
+        d.lastExit = clock;
+        return true;
+    }
+
+    bool leaveThroughDoor(Person& p) {
+        if (!passDoor(p.door)) return false;
+        p.hasLeft = true;
+        return true;
+    }
+
+    // Protok po vratima za poslednju fazu (ulazak ili izlazak)
+    void printDoorStats(bool exiting) const {
+        for (size_t i = 0; i < doors.size(); i++) {
+            const Door& d = doors[i];
+            int count = exiting ? d.exited : d.entered;
+            float last = exiting ? d.lastExit : d.lastEnter;
+            std::cout << "  Vrata " << i + 1 << ": " << count << (exiting ? " izaslo" : " uslo");
+            if (count > 0 && last > 0.0f) std::cout << ", protok " << count / last << " ljudi/s";
+            std::cout << std::endl;
+        }
+    }
+
+    // Korak po polju toka: od centra do centra celije, O(1) po agentu bez obzira na broj agenata.
+    // Ulazak: stablom od vrata ka celiji sedista, pa pravo na sediste. Izlazak: obrnuto.
+    void updateOnFlowField(Person& p, float dt) {
+        const NavGrid& grid = nav->grid;
+        const FlowField& field = nav->doors[p.door];
+        float step = p.speed * dt;
+
+        for (int guard = 0; guard < 16 && step > 0.0f; guard++) {
+            if (!p.isExiting && p.seated) return;
+
+            float tx, ty;
+            if (!p.reachedRow) grid.cellCenter(p.navCell, tx, ty);
+            else if (!p.isExiting) { tx = p.targetX; ty = p.targetY; }
+            else { tx = p.startX; ty = p.startY; }
+
+            float dx = tx - p.x, dy = ty - p.y;
+            float d = std::sqrt(dx * dx + dy * dy);
+            if (d > step) {
+                p.x += dx / d * step;
+                p.y += dy / d * step;
+                return;
+            }
+            p.x = tx;
+            p.y = ty;
+            step -= d;
+
+            // Stigli smo do tacke - biramo sledecu
+            if (!p.isExiting) {
+                if (p.reachedRow) { p.seated = true; return; }
+                int next = field.nextToward(grid, p.navCell, p.goalCell);
+                if (next < 0) p.reachedRow = true; // u celiji sedista (ili je nedostizna) - pravo na sediste
+                else p.navCell = next;
+            }
+            else {
+                if (p.reachedRow) { leaveThroughDoor(p); return; }
+                int next = field.next(grid, p.navCell);
+                if (next < 0) p.reachedRow = true; // na vratima
+                else p.navCell = next;
             }
         }
     }
 
     // IZMENA: Ako nema ljudi, smatramo da su svi seli (da ne blokiramo logiku)
     bool areAllSeated() {
+        if (!arrivalQueue.empty() || lodMoving != 0) return false;
+        if (compact) {
+            for (const CompactPerson& c : compactPeople) {
+                if ((c.flags & PERSON_PHASE_MASK) != PHASE_SEATED) return false;
+            }
+            return true;
+        }
         if (people.empty()) return true;
         for (const auto& p : people) {
             if (!p.seated) return false;
@@ -143,36 +634,320 @@ public:
         return true;
     }
 
+    // Ko izadje, odmah se vraca u skladiste
     bool areAllGone() {
-        if (people.empty()) return true;
-        for (const auto& p : people) {
-            if (!p.hasLeft) return false;
+        return count() == 0;
+    }
+
+    // Broj ljudi trenutno u sali (u aktivnom zapisu)
+    size_t count() const {
+        return (compact ? compactPeople.size() : people.size()) + lodAgents.size();
+    }
+
+    // Koliko memorije zauzimaju ljudi i zajednicka tabela sedista
+    void printMemoryFootprint() const {
+        size_t perPerson = compact ? sizeof(CompactPerson) : sizeof(Person);
+        size_t capacity = compact ? compactPeople.capacity() : people.capacity();
+        size_t tableBytes = compact ? seatTargets.size() * sizeof(SeatTarget) : 0;
+        std::cout << "  " << (compact ? "Sazet" : "Pun") << " zapis: " << perPerson << " B po coveku, "
+            << count() << " ljudi u sali, skladiste " << capacity << " x " << perPerson << " B = "
+            << capacity * perPerson / 1024 << " KB";
+        if (compact) std::cout << " + tabela sedista " << tableBytes / 1024 << " KB";
+        std::cout << " (pun zapis: " << sizeof(Person) << " B, sazet: " << sizeof(CompactPerson) << " B)" << std::endl;
+    }
+
+    void draw(SpriteBatch& batch) {
+        batch.nextLayer();
+        for (const Person& p : people) batch.draw(personSprite, p.x, p.y, 0.08f, 0.08f, 1.0f, 1.0f, 1.0f, 1.0f);
+        for (const CompactPerson& c : compactPeople) {
+            batch.draw(personSprite, fromFixedPos(c.x), fromFixedPos(c.y), 0.08f, 0.08f, 1.0f, 1.0f, 1.0f, 1.0f);
         }
-        return true;
+        if (lod) drawDensity(batch);
     }
 
-    void draw(unsigned int shaderProgram, int uPosLoc, int uSizeLoc, int uColorLoc, int uUseTextureLoc) {
-        glUniform1i(uUseTextureLoc, 1);
-        if (personTexture != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, personTexture);
+    // Zbirni ljudi: tamnija celija grube mreze sto ih je vise (logaritamski), preko pojedinacnih
+    void drawDensity(SpriteBatch& batch) {
+        batch.nextLayer();
+        float size = density.cellSize();
+        for (int i = 0; i < (int)density.counts.size(); i++) {
+            int n = density.counts[i];
+            if (n <= 0) continue;
+            float alpha = std::min(0.9f, 0.2f + 0.08f * std::log2((float)n));
+            batch.drawRect(-1.0f + (i % density.size) * size, -1.0f + (i / density.size) * size, size, size, 0.25f, 0.1f, 0.1f, alpha);
+        }
+    }
+
+    void clear() {
+        people.releaseAll();
+        compactPeople.releaseAll();
+        arrivalQueue.clear();
+        moving = 0;
+        lodAgents.releaseAll();
+        lodEvents.clear();
+        std::fill(density.counts.begin(), density.counts.end(), 0);
+        lodMoving = 0;
+        exitPending = false;
+    }
+
+    // Putanja zbirnog coveka: ulazak od vrata (vertikalno pa horizontalno), izlazak od sedista obrnuto.
+    // Iste tacke kao u sazetom zapisu, pa pojedinacni i zbirni covek idu istim putem.
+    LegPath lodPath(const LodAgent& a) const {
+        const SeatTarget& t = seatTargets[a.seat];
+        float tx = fromFixedPos(t.x), ty = fromFixedPos(t.y);
+        const Door& d = doors[a.door];
+        float dx = compact ? quantizePos(d.x) : d.x, dy = compact ? quantizePos(d.y) : d.y;
+        if (a.phase == PHASE_EXITING) return LegPath(tx, ty, dx, ty, dx, dy);
+        return LegPath(dx, dy, dx, ty, tx, ty);
+    }
+
+    static float lodDistance(const LodAgent& a, float t) {
+        return t <= a.t0 ? a.s0 : a.s0 + a.speed * (t - a.t0);
+    }
+
+private:
+    // Pomocni nizovi se cuvaju izmedju projekcija (bez alokacija u ustaljenom radu)
+    std::vector<int> occupiedIndices;
+    std::vector<SeatTarget> seatTargets;
+    std::vector<int> agents;
+    std::vector<float> travel;
+    std::vector<int> doorOf, slotOf;
+    std::vector<ArrivalEvent> arrivalQueue; // min-heap po vremenu dolaska
+    std::vector<LodEvent> lodEvents;        // min-heap: sledeci dogadjaj svakog zbirnog coveka
+    size_t densityCursor;                   // dokle je stiglo osvezavanje gustine (u krug)
+    size_t exitCursor;                      // dokle je stigao pocetak izlaska zbirnih (kroz skladiste)
+    bool exitPending;                       // neki zbirni jos sede i cekaju da ustanu
+    std::vector<int> exitQueued;            // koliko je do sada rasporedjeno na svaka vrata pri izlasku
+
+    int createLod(int seatIndex, float speed) {
+        int id = lodAgents.acquire();
+        LodAgent& a = lodAgents[id];
+        a.seat = (uint32_t)seatIndex;
+        a.speed = speed;
+        a.door = 0;
+        a.phase = PHASE_ENTERING;
+        a.credited = 0;
+        a.t0 = 0.0f;
+        a.s0 = 0.0f;
+        a.densityCell = -1;
+        return id;
+    }
+
+    // Zbirni covek pred vratima: prolazi u trenutku passTime i od tada ide svojom putanjom
+    void admitLod(int id, float passTime) {
+        LodAgent& a = lodAgents[id];
+        a.t0 = passTime;
+        a.s0 = 0.0f;
+        lodMoving++;
+        density.move(a.densityCell, density.cellAt(doors[a.door].x, doors[a.door].y));
+        scheduleLod(id);
+    }
+
+    // Sledeci dogadjaj: ulazak u fokus (ako putanja prolazi kroz njega) ili kraj putanje
+    void scheduleLod(int id) {
+        const LodAgent& a = lodAgents[id];
+        LegPath path = lodPath(a);
+        float s = lodDistance(a, clock);
+        float enter = path.enterFocus(focus, s);
+        LodEvent e;
+        e.agent = id;
+        if (enter >= 0.0f) {
+            e.kind = LOD_PROMOTE;
+            e.time = enter <= s ? clock : a.t0 + (enter - a.s0) / a.speed;
         }
         else {
-            glUniform1i(uUseTextureLoc, 0);
+            e.kind = LOD_ARRIVE;
+            e.time = a.t0 + (path.length - a.s0) / a.speed;
         }
+        lodEvents.push_back(e);
+        std::push_heap(lodEvents.begin(), lodEvents.end(), laterLodEvent);
+    }
 
-        glUniform4f(uColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+    // Najvise lodEventBudget po tiku: ostali dospeli dogadjaji ostaju u redu za sledeci tik. Zakasneli
+    // dogadjaj se obradjuje sa trenutnim vremenom (promote krece od lodDistance u tom trenutku).
+    void processLodEvents() {
+        for (int handled = 0; handled < lodEventBudget && !lodEvents.empty() && lodEvents.front().time <= clock; handled++) {
+            std::pop_heap(lodEvents.begin(), lodEvents.end(), laterLodEvent);
+            LodEvent e = lodEvents.back();
+            lodEvents.pop_back();
+            LodAgent& a = lodAgents[e.agent];
 
-        for (const Person& p : people) {
-            if (p.hasLeft) continue;
-            glUniform2f(uPosLoc, p.x, p.y);
-            glUniform2f(uSizeLoc, 0.08f, 0.08f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+            if (e.kind == LOD_PROMOTE) {
+                promote(e.agent);
+                continue;
+            }
+            if (a.phase == PHASE_ENTERING) {
+                creditLodEntry(a);
+                a.phase = PHASE_SEATED;
+                lodMoving--;
+                const SeatTarget& t = seatTargets[a.seat];
+                density.move(a.densityCell, density.cellAt(fromFixedPos(t.x), fromFixedPos(t.y)));
+            }
+            else if (passDoor(a.door)) {
+                density.move(a.densityCell, -1);
+                lodAgents.release(e.agent);
+                lodMoving--;
+            }
+            else {
+                // Vrata su zauzeta: ceka ispred njih do prvog slobodnog trenutka
+                e.time = doors[a.door].nextFree;
+                lodEvents.push_back(e);
+                std::push_heap(lodEvents.begin(), lodEvents.end(), laterLodEvent);
+            }
         }
     }
 
-    void clear() {
-        people.clear();
+    // Prolazak kroz vrata dok je covek bio zbirni upisuje se naknadno (sa stvarnim vremenom prolaska)
+    void creditLodEntry(LodAgent& a) {
+        if (a.credited || a.phase != PHASE_ENTERING) return;
+        Door& d = doors[a.door];
+        d.entered++;
+        d.lastEnter = std::max(d.lastEnter, a.t0);
+        a.credited = 1;
+    }
+
+    // Zbirni covek ulazi u fokus: postaje pojedinacan, na mestu do kog je stigao
+    void promote(int id) {
+        LodAgent& a = lodAgents[id];
+        LegPath path = lodPath(a);
+        const SeatTarget& t = seatTargets[a.seat];
+        float s = std::min(lodDistance(a, clock), path.length);
+
+        Person p;
+        path.pointAt(s, p.x, p.y);
+        p.targetX = fromFixedPos(t.x);
+        p.targetY = fromFixedPos(t.y);
+        p.isExiting = a.phase == PHASE_EXITING;
+        p.startX = p.isExiting ? path.cx : path.ax; // vrata su na kraju putanje izlaska, na pocetku ulaska
+        p.startY = p.isExiting ? path.cy : path.ay;
+        p.speed = a.speed;
+        p.reachedRow = !p.isExiting && s >= path.first;
+        p.seated = false;
+        p.hasLeft = false;
+        p.navCell = -1;
+        p.goalCell = -1;
+        p.seatIndex = (int)a.seat;
+        p.door = a.door;
+        if (!p.isExiting && clock < a.t0) p.wait = a.t0 - clock; // jos ceka na vratima - prolazak upisuje pojedinacni
+        else {
+            creditLodEntry(a);
+            p.wait = -1.0f;
+        }
+
+        density.move(a.densityCell, -1);
+        lodAgents.release(id);
+        lodMoving--;
+        moving++;
+
+        if (compact) {
+            CompactPerson& c = compactPeople[compactPeople.acquire()];
+            c.seat = (uint32_t)p.seatIndex;
+            c.speed = (uint16_t)(p.speed * PERSON_SPEED_SCALE);
+            c.door = (uint8_t)p.door;
+            pack(p, c);
+        }
+        else people[people.acquire()] = p;
+    }
+
+    // Pojedinacni covek je izasao iz fokusa: postaje zbirni, od tacke do koje je stigao
+    void demote(const Person& p) {
+        int id = createLod(p.seatIndex, p.speed);
+        LodAgent& a = lodAgents[id];
+        a.door = (uint8_t)p.door;
+        a.phase = p.isExiting ? PHASE_EXITING : PHASE_ENTERING;
+        LegPath path = lodPath(a);
+        if (!p.isExiting && p.wait >= 0.0f) {
+            a.t0 = clock + p.wait;
+        }
+        else {
+            a.t0 = clock;
+            a.credited = 1;
+            if (!p.isExiting) a.s0 = !p.reachedRow ? std::fabs(p.y - path.ay) : path.first + std::fabs(p.x - path.bx);
+            else a.s0 = p.x != path.bx ? std::fabs(p.x - path.ax) : path.first + std::fabs(p.y - path.by);
+        }
+        lodMoving++;
+        density.move(a.densityCell, density.cellAt(p.x, p.y));
+        scheduleLod(id);
+    }
+
+    // Izlazak: svi (pojedinacni koji sede i zbirni) krecu kao zbirni, sa novim rasporedom po vratima.
+    // Pojedinacnih je najvise koliko staje u fokus, pa oni postaju zbirni odmah; zbirni ustaju i dobijaju
+    // vrata u delovima od exitBudget po tiku (continueLodExit).
+    void startLodExit() {
+        for (const Person& p : people) demoteSeated(p.seatIndex, p.speed, p.door);
+        for (const CompactPerson& c : compactPeople) demoteSeated((int)c.seat, c.speed / PERSON_SPEED_SCALE, c.door);
+        people.releaseAll();
+        compactPeople.releaseAll();
+        lodEvents.clear();
+
+        clock = 0.0f;
+        for (Door& d : doors) d.resetStats();
+        moving = 0;
+        lodMoving = 0;
+        exitCursor = 0;
+        exitPending = true;
+        exitQueued.assign(doors.size(), 0);
+        continueLodExit();
+    }
+
+    // Sledeci deo izlaska. Svi krecu od t0 = 0, pa onaj ko dobije vrata tik kasnije vec je tamo gde bi bio;
+    // red na vratima se nastavlja preko delova (exitQueued).
+    void continueLodExit() {
+        size_t capacity = lodAgents.capacity();
+        bool first = exitCursor == 0;
+        agents.clear();
+        while (exitCursor < capacity && (int)agents.size() < exitBudget) {
+            int i = (int)exitCursor++;
+            if (!lodAgents.isAlive(i) || lodAgents[i].phase == PHASE_EXITING) continue;
+            agents.push_back(i);
+        }
+        if (exitCursor >= capacity) exitPending = false;
+
+        int n = (int)agents.size();
+        if (n == 0) return;
+        for (int i = 0; i < n; i++) {
+            LodAgent& a = lodAgents[agents[i]];
+            a.phase = PHASE_EXITING;
+            a.credited = 1;
+        }
+        fillTravel(lodAgents);
+        // Ceo izlazak u jednom delu (manje sale): tacan raspored kao i pre, bez nastavljanja reda
+        assigner.assign(travel, n, doors, doorOf, slotOf, first && !exitPending ? NULL : &exitQueued);
+        for (int i = 0; i < n; i++) {
+            LodAgent& a = lodAgents[agents[i]];
+            setDoor(a, doorOf[i]);
+            exitQueued[doorOf[i]]++;
+            a.t0 = 0.0f;
+            a.s0 = 0.0f;
+            lodMoving++;
+            scheduleLod(agents[i]);
+        }
+    }
+
+    void demoteSeated(int seat, float speed, int door) {
+        int id = createLod(seat, speed);
+        LodAgent& a = lodAgents[id];
+        a.door = (uint8_t)door;
+        a.phase = PHASE_SEATED;
+        const SeatTarget& t = seatTargets[seat];
+        density.move(a.densityCell, density.cellAt(fromFixedPos(t.x), fromFixedPos(t.y)));
+    }
+
+    // Gustina zbirnih ljudi u pokretu se osvezava u krug, najvise densityBudget po tiku:
+    // cena po tiku je ogranicena, a prikaz kasni najvise (broj zbirnih / budzet) tikova
+    void refreshDensity() {
+        size_t capacity = lodAgents.capacity();
+        if (capacity == 0) return;
+        size_t budget = std::min(capacity, (size_t)densityBudget);
+        for (size_t k = 0; k < budget; k++) {
+            if (densityCursor >= capacity) densityCursor = 0;
+            int i = (int)densityCursor++;
+            if (!lodAgents.isAlive(i)) continue;
+            LodAgent& a = lodAgents[i];
+            if (a.phase == PHASE_SEATED) continue;
+            float x, y;
+            lodPath(a).pointAt(lodDistance(a, clock), x, y);
+            density.move(a.densityCell, density.cellAt(x, y));
+        }
     }
 };
 
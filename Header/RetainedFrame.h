@@ -0,0 +1,162 @@
+#pragma once
+#ifndef RETAINED_FRAME_H
+#define RETAINED_FRAME_H
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Pravougaonik u pikselima [x0, x1) x [y0, y1), y od dna prozora (kao glScissor)
+struct PixelRect {
+    int x0, y0, x1, y1;
+
+    int64_t area() const { return (int64_t)(x1 - x0) * (y1 - y0); }
+
+    bool overlaps(const PixelRect& o) const {
+        return x0 <= o.x1 && o.x0 <= x1 && y0 <= o.y1 && o.y0 <= y1; // i oni koji se dodiruju
+    }
+
+    void merge(const PixelRect& o) {
+        x0 = std::min(x0, o.x0);
+        y0 = std::min(y0, o.y0);
+        x1 = std::max(x1, o.x1);
+        y1 = std::max(y1, o.y1);
+    }
+};
+
+// Scena se crta u trajan framebuffer, a na ekran se samo kopira. Iz frejma u frejm se ponovo crtaju
+// samo prljavi delovi (promenjena sedista, pomereni ljudi...), svaki sa glScissor; ako je prljavo
+// vise od fullRedrawRatio ekrana (ili previse razbacanih delova), crta se sve.
+class RetainedFrame {
+public:
+    float fullRedrawRatio = 0.5f;
+    int maxRects = 8;          // preko ovoga se delovi spajaju u jedan obuhvatni
+
+    // Statistika
+    uint64_t framesFull = 0, framesPartial = 0, framesClean = 0;
+    uint64_t pixelsDrawn = 0, pixelsSaved = 0;
+    uint64_t drawsIssued = 0, drawsFull = 0; // drawsFull: koliko bi bilo da se svaki frejm crta ceo
+
+    bool init(int w, int h) {
+        width = w;
+        height = h;
+        if (fbo == 0) {
+            glGenFramebuffers(1, &fbo);
+            glGenTextures(1, &color);
+        }
+        glBindTexture(GL_TEXTURE_2D, color);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!complete) std::cout << "GRESKA: Framebuffer za delimicno crtanje nije kompletan." << std::endl;
+        invalidate();
+        return complete;
+    }
+
+    // Isto kao init, samo ako se velicina promenila. Vraca true ako je tekstura napravljena
+    // ponovo: init vezuje teksturu mimo GlStateCache, pa pozivalac tada zove gl.invalidate().
+    bool resize(int w, int h) {
+        if (w == width && h == height) return false;
+        init(w, h);
+        return true;
+    }
+
+    // Sledeci frejm se crta ceo
+    void invalidate() { full = true; }
+
+    // Prljav deo scene u NDC (donji levi ugao i velicina, kao uPos/uSize); zaokruzuje se nadole/nagore
+    // i prosiruje za jedan piksel zbog filtriranja tekstura na ivicama
+    void addNdc(float x, float y, float w, float h) {
+        if (full) return;
+        PixelRect r;
+        r.x0 = std::max((int)((x + 1.0f) * 0.5f * width) - 1, 0);
+        r.y0 = std::max((int)((y + 1.0f) * 0.5f * height) - 1, 0);
+        r.x1 = std::min((int)((x + w + 1.0f) * 0.5f * width + 1.0f) + 1, width);
+        r.y1 = std::min((int)((y + h + 1.0f) * 0.5f * height + 1.0f) + 1, height);
+        if (r.x0 >= r.x1 || r.y0 >= r.y1) return;
+
+        // Spaja se sa svim delovima koje dodiruje (i oni mogu zatim da dodirnu druge)
+        for (size_t i = 0; i < rects.size();) {
+            if (rects[i].overlaps(r)) {
+                r.merge(rects[i]);
+                rects[i] = rects.back();
+                rects.pop_back();
+                i = 0;
+            }
+            else i++;
+        }
+        rects.push_back(r);
+        if ((int)rects.size() > maxRects) {
+            for (size_t i = 1; i < rects.size(); i++) rects[0].merge(rects[i]);
+            rects.resize(1);
+        }
+    }
+
+    // Crta prljave delove (drawScene za svaki, pod glScissor) ili celu scenu u framebuffer, pa ga
+    // kopira na ekran. drawsPerPass: koliko poziva za crtanje ima jedan prolaz kroz scenu.
+    template <typename F>
+    void render(int drawsPerPass, F drawScene) {
+        int64_t screen = (int64_t)width * height;
+        int64_t dirty = 0;
+        for (const PixelRect& r : rects) dirty += r.area();
+        if (dirty > screen * fullRedrawRatio) full = true;
+        drawsFull += drawsPerPass;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        if (full) {
+            glClear(GL_COLOR_BUFFER_BIT);
+            drawScene();
+            framesFull++;
+            pixelsDrawn += screen;
+            drawsIssued += drawsPerPass;
+        }
+        else if (rects.empty()) {
+            framesClean++;
+            pixelsSaved += screen;
+        }
+        else {
+            glEnable(GL_SCISSOR_TEST);
+            for (const PixelRect& r : rects) {
+                glScissor(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+                glClear(GL_COLOR_BUFFER_BIT);
+                drawScene();
+            }
+            glDisable(GL_SCISSOR_TEST);
+            framesPartial++;
+            pixelsDrawn += dirty;
+            pixelsSaved += screen - dirty;
+            drawsIssued += drawsPerPass * rects.size(); // vise delova = vise poziva, ali manje piksela
+        }
+        rects.clear();
+        full = false;
+
+        // Na ekran: ceo framebuffer (zadnji bafer posle zamene nema sacuvan sadrzaj)
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void destroy() {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &color);
+        fbo = color = 0;
+    }
+
+private:
+    unsigned int fbo = 0;
+    unsigned int color = 0;
+    int width = 0, height = 0;
+    bool full = true;
+    std::vector<PixelRect> rects;
+};
+
+#endif
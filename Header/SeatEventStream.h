@@ -0,0 +1,112 @@
+#pragma once
+#ifndef SEAT_EVENT_STREAM_H
+#define SEAT_EVENT_STREAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Posebna vrednost indeksa: promenjena su sva sedista (reset sale) - pretplatnik treba da ponovo procita sve
+const uint32_t SEAT_EVENT_ALL = 0xFFFFFF;
+
+struct SeatEvent {
+    uint32_t seat;
+    uint8_t oldState;
+    uint8_t newState;
+};
+
+// Tok promena stanja sedista: ogranicen prsten (ring buffer) bez zakljucavanja,
+// jedan proizvodjac (SeatManager) i proizvoljan broj pretplatnika koji svi vide sve dogadjaje.
+//
+// Svaki slot je jedan 64-bitni atomik: gornja 32 bita su redni broj dogadjaja (+1),
+// donja 32 bita sam dogadjaj (24 bita sediste, 4 staro stanje, 4 novo stanje).
+// Zato citalac nikad ne vidi poluupisan dogadjaj, a proizvodjac nikad ne ceka citaoce:
+// ako neko zaostane vise od kapaciteta, prepoznace da je preskocen (overrun) i uradi pun prolaz.
+class SeatEventStream {
+public:
+    // Kapacitet mora biti stepen dvojke
+    explicit SeatEventStream(uint32_t capacityPow2 = 4096)
+        : capacity(capacityPow2), mask(capacityPow2 - 1), slots(new std::atomic<uint64_t>[capacityPow2]) {
+        for (uint32_t i = 0; i < capacity; i++) slots[i].store(0, std::memory_order_relaxed);
+        head.store(0, std::memory_order_relaxed);
+    }
+
+    // Poziva samo jedan nit (vlasnik SeatManager-a)
+    void publish(uint32_t seat, int oldState, int newState) {
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        uint64_t payload = (uint64_t)(seat & 0xFFFFFF) | ((uint64_t)(oldState & 0xF) << 24) | ((uint64_t)(newState & 0xF) << 28);
+        uint64_t tag = (uint64_t)(uint32_t)(pos + 1) << 32;
+        slots[pos & mask].store(tag | payload, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_release);
+    }
+
+    uint64_t published() const { return head.load(std::memory_order_acquire); }
+
+    uint32_t getCapacity() const { return capacity; }
+
+private:
+    friend class SeatEventSubscriber;
+
+    const uint32_t capacity;
+    const uint32_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    std::atomic<uint64_t> head;
+};
+
+// Pretplatnik cita promene od svoje pozicije (cursor) nadalje, bez uticaja na druge pretplatnike
+class SeatEventSubscriber {
+public:
+    uint64_t received = 0;
+    uint64_t overruns = 0;
+
+    SeatEventSubscriber() : stream(NULL), cursor(0) {}
+
+    // Pretplata krece od trenutnog kraja toka (stare promene se ne vide)
+    explicit SeatEventSubscriber(SeatEventStream& s) : stream(&s), cursor(s.published()) {}
+
+    void subscribe(SeatEventStream& s) {
+        stream = &s;
+        cursor = s.published();
+    }
+
+    // Poziva fn(const SeatEvent&) za svaki novi dogadjaj (najvise do pozicije "until").
+    // Vraca false ako je pretplatnik zaostao vise od kapaciteta prstena - tada su neki
+    // dogadjaji izgubljeni i pozivalac mora ponovo da procita celo stanje.
+    template <typename F>
+    bool poll(F fn, uint64_t until = ~0ull) {
+        if (stream == NULL) return true;
+        uint64_t end = stream->published();
+        if (until < end) end = until;
+        if (stream->published() - cursor > stream->capacity) return skipTo(end);
+
+        while (cursor < end) {
+            uint64_t value = stream->slots[cursor & stream->mask].load(std::memory_order_acquire);
+            if ((uint32_t)(value >> 32) != (uint32_t)(cursor + 1)) return skipTo(end);
+
+            SeatEvent e;
+            e.seat = (uint32_t)(value & 0xFFFFFF);
+            e.oldState = (uint8_t)((value >> 24) & 0xF);
+            e.newState = (uint8_t)((value >> 28) & 0xF);
+            fn(e);
+
+            cursor++;
+            received++;
+        }
+        return true;
+    }
+
+    bool hasPending() const { return stream != NULL && cursor < stream->published(); }
+
+private:
+    SeatEventStream* stream;
+    uint64_t cursor;
+
+    // Preskace izgubljene dogadjaje; pozivalac posle toga cita celo stanje (do pozicije end)
+    bool skipTo(uint64_t end) {
+        if (cursor < end) cursor = end;
+        overruns++;
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef SEAT_JOURNAL_H
+#define SEAT_JOURNAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class SeatManager;
+
+// Jedan zapis u zurnalu (8 bajtova).
+// seq mora da raste za tacno 1 od zapisa do zapisa - tako se pri oporavku
+// prepoznaje nedovrsen (pokidan) zapis na kraju fajla, bez posebne kontrolne sume.
+struct JournalRecord {
+    uint32_t seq;
+    uint32_t packed; // donja 24 bita: indeks sedista, gornjih 8: novo stanje
+};
+
+// Posebna vrednost indeksa: "sva sedista" (reset sale posle projekcije)
+const uint32_t JOURNAL_ALL_SEATS = 0xFFFFFF;
+
+// Zurnal (write-ahead log) za stanje sedista.
+// Svaka promena stanja se dodaje u bafer, a na disk se upisuje grupno (group commit):
+// jedan fsync pokriva sve promene nakupljene od prethodnog upisa.
+// Povremeno se pravi checkpoint (snimak svih sedista) i zurnal se prazni.
+class SeatJournal {
+public:
+    // Politika grupnog upisa
+    size_t maxBatch = 256;              // upisi odmah kad se nakupi ovoliko promena
+    double maxDelay = 0.05;             // ili kad najstarija promena ceka duze od ovoga (sekunde)
+    uint32_t checkpointInterval = 4096; // checkpoint posle ovoliko zapisa u zurnalu
+
+    // Statistika
+    uint64_t recordsWritten = 0;
+    uint64_t syncCount = 0;
+    uint64_t checkpointCount = 0;
+
+    SeatJournal();
+    ~SeatJournal();
+
+    // Otvara (ili pravi) fajlove "<prefix>.journal" i "<prefix>.checkpoint"
+    bool open(const std::string& pathPrefix);
+    void close();
+    bool isOpen() const { return file != NULL; }
+
+    // Ucitava checkpoint, ponavlja rep zurnala i odmah pravi novi checkpoint.
+    // Vraca broj ponovljenih zapisa ili -1 ako nema sacuvanog stanja.
+    int recover(SeatManager& sm);
+
+    // Dodaje promenu u bafer (ne dira disk)
+    void append(uint32_t seatIndex, int newState);
+
+    // Upisuje bafer i radi fsync
+    void commit();
+
+    // Group commit: upisuje samo ako je bafer pun ili je istekao maxDelay
+    void commitIfDue(double now);
+
+    // Pravi snimak svih sedista i prazni zurnal
+    bool checkpoint(const SeatManager& sm);
+
+    bool wantsCheckpoint() const { return recordsSinceCheckpoint >= checkpointInterval; }
+
+    // Kada commitIfDue treba ponovo pozvati (-1: bafer je prazan) - do tada petlja moze da spava
+    double commitDeadline(double now) const {
+        if (pending.empty()) return -1.0;
+        return firstPendingTime < 0.0 ? now : firstPendingTime + maxDelay;
+    }
+
+private:
+    std::string journalPath;
+    std::string checkpointPath;
+    FILE* file;
+
+    std::vector<JournalRecord> pending;
+    double firstPendingTime;
+    uint32_t nextSeq;
+    uint32_t recordsSinceCheckpoint;
+
+    bool truncateJournal();
+};
+
+#endif
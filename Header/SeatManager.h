@@ -6,6 +6,9 @@
 #include <iostream> 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "SeatJournal.h"
+#include "SeatEventStream.h"
+#include "InputRecorder.h"
 
 enum SeatState {
     FREE,       // Slobodno (Plavo)
@@ -27,12 +30,24 @@ public:
     bool oldLeftClickState;
     bool oldKeyStates[10];
 
+    // Opciono: ako je postavljen, svaka promena stanja se upisuje u zurnal
+    SeatJournal* journal;
+
+    // Opciono: tok promena za pretplatnike (renderer, statistika...) da ne bi skenirali sva sedista
+    SeatEventStream* events;
+
+    // Raste pri svakoj promeni stanja (da bi se znalo da li treba objaviti novi snimak sale)
+    uint64_t version;
+
     // Konstante za dimenzije
     const int ROWS = 8;
     const int COLS = 9; // <--- PROMENA: SADA JE 9 KOLONA
 
     SeatManager() {
         oldLeftClickState = false;
+        journal = NULL;
+        events = NULL;
+        version = 0;
         for (int i = 0; i < 10; i++) oldKeyStates[i] = false;
         initSeats();
     }
@@ -63,8 +78,45 @@ public:
         }
     }
 
-    void buyTickets(int n) {
-        if (n <= 0 || n > COLS) return; // Zastita: ne mozemo kupiti vise od 9
+    // Sve promene stanja idu kroz ove funkcije, da bi zurnal i pretplatnici videli svaku promenu
+    void setSeatState(int index, SeatState state) {
+        SeatState old = seats[index].state;
+        if (old == state) return;
+        seats[index].state = state;
+        version++;
+        if (journal) journal->append(index, state);
+        if (events) events->publish(index, old, state);
+    }
+
+    void resetAllSeats() {
+        for (auto& s : seats) s.state = FREE;
+        version++;
+        if (journal) journal->append(JOURNAL_ALL_SEATS, FREE);
+        if (events) events->publish(SEAT_EVENT_ALL, FREE, FREE);
+    }
+
+    // Poziva se jednom po frejmu: grupni upis u zurnal i povremeni checkpoint
+    void flushJournal(double now) {
+        if (!journal) return;
+        journal->commitIfDue(now);
+        if (journal->wantsCheckpoint()) journal->checkpoint(*this);
+    }
+
+    bool reserveSeat(int index) {
+        if (index < 0 || index >= (int)seats.size() || seats[index].state != FREE) return false;
+        setSeatState(index, RESERVED);
+        return true;
+    }
+
+    bool cancelReservation(int index) {
+        if (index < 0 || index >= (int)seats.size() || seats[index].state != RESERVED) return false;
+        setSeatState(index, FREE);
+        return true;
+    }
+
+    // Vraca red u kome su kupljena sedista ili -1 ako nema N susednih slobodnih
+    int buyTickets(int n) {
+        if (n <= 0 || n > COLS) return -1; // Zastita: ne mozemo kupiti vise od 9
 
         // Trazimo od poslednjeg reda ka prvom
         for (int row = ROWS - 1; row >= 0; --row) {
@@ -87,50 +139,77 @@ public:
                 }
 
                 if (foundGroup) {
-                    std::cout << "Kupovina uspesna! Red: " << row + 1 << ", " << n << " sedista." << std::endl;
                     for (int k = 0; k < n; ++k) {
                         int index = row * COLS + (col - k);
-                        seats[index].state = SOLD;
+                        setSeatState(index, SOLD);
                     }
-                    return;
+                    return row;
                 }
             }
         }
-        std::cout << "Nema dovoljno mesta za " << n << " sedista jedan do drugog." << std::endl;
+        return -1;
     }
 
-    void processMouseInput(GLFWwindow* window, int screenWidth, int screenHeight) {
+    // Zivi ulaz: tasteri i mis se pretvaraju u dogadjaje (samo pritisak, ne i drzanje),
+    // da bi isti dogadjaji mogli da se snime i kasnije reprodukuju
+    void pollInput(GLFWwindow* window, int screenWidth, int screenHeight, std::vector<InputEvent>& out) {
         int state = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
 
         if (state == GLFW_PRESS && oldLeftClickState == GLFW_RELEASE) {
             double mouseX, mouseY;
             glfwGetCursorPos(window, &mouseX, &mouseY);
 
-            float ndcX = (2.0f * (float)mouseX / (float)screenWidth) - 1.0f;
-            float ndcY = 1.0f - (2.0f * (float)mouseY / (float)screenHeight);
-
-            for (Seat& s : seats) {
-                if (ndcX >= s.x && ndcX <= (s.x + s.width) && ndcY >= s.y && ndcY <= (s.y + s.height)) {
-                    if (s.state == FREE) s.state = RESERVED;
-                    else if (s.state == RESERVED) s.state = FREE;
-                    break;
-                }
-            }
+            InputEvent e;
+            e.type = INPUT_CLICK;
+            e.count = 0;
+            e.x = (2.0f * (float)mouseX / (float)screenWidth) - 1.0f;
+            e.y = 1.0f - (2.0f * (float)mouseY / (float)screenHeight);
+            out.push_back(e);
         }
         oldLeftClickState = (state == GLFW_PRESS);
-    }
 
-    void processKeyboardInput(GLFWwindow* window) {
         // Tasteri 1-9
         for (int i = 1; i <= 9; i++) {
             int key = GLFW_KEY_0 + i;
-            int state = glfwGetKey(window, key);
+            int keyState = glfwGetKey(window, key);
+
+            if (keyState == GLFW_PRESS && oldKeyStates[i] == false) {
+                InputEvent e;
+                e.type = INPUT_BUY;
+                e.count = (uint8_t)i;
+                e.x = e.y = 0.0f;
+                out.push_back(e);
+            }
+            oldKeyStates[i] = (keyState == GLFW_PRESS);
+        }
 
-            if (state == GLFW_PRESS && oldKeyStates[i] == false) {
-                buyTickets(i);
+        if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
+            InputEvent e;
+            e.type = INPUT_START;
+            e.count = 0;
+            e.x = e.y = 0.0f;
+            out.push_back(e);
+        }
+    }
+
+    // Primena jednog dogadjaja; vraca true ako je trazen pocetak projekcije
+    bool applyInput(const InputEvent& e) {
+        if (e.type == INPUT_CLICK) {
+            for (int i = 0; i < (int)seats.size(); i++) {
+                const Seat& s = seats[i];
+                if (e.x >= s.x && e.x <= (s.x + s.width) && e.y >= s.y && e.y <= (s.y + s.height)) {
+                    if (s.state == FREE) setSeatState(i, RESERVED);
+                    else if (s.state == RESERVED) setSeatState(i, FREE);
+                    break;
+                }
             }
-            oldKeyStates[i] = (state == GLFW_PRESS);
         }
+        else if (e.type == INPUT_BUY) {
+            int row = buyTickets(e.count);
+            if (row >= 0) std::cout << "Kupovina uspesna! Red: " << row + 1 << ", " << (int)e.count << " sedista." << std::endl;
+            else std::cout << "Nema dovoljno mesta za " << (int)e.count << " sedista jedan do drugog." << std::endl;
+        }
+        return e.type == INPUT_START;
     }
 };
 
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef SEAT_RENDERER_H
+#define SEAT_RENDERER_H
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <vector>
+#include "SeatManager.h"
+#include "SeatEventStream.h"
+#include "SeatSnapshot.h"
+#include "GlStateCache.h"
+
+// Crta sva sedista jednim instanciranim pozivom.
+// Podaci o instancama (pravougaonik + boja) stoje u VBO-u na GPU-u i menjaju se samo
+// za sedista koja su stigla kroz tok promena - nema skeniranja svih sedista svakog frejma.
+class SeatRenderer {
+public:
+    // Broj sedista osvezenih u poslednjem frejmu (za merenje)
+    int lastUpdatedSeats;
+
+    // Sta se promenilo u poslednjem update (za delimicno crtanje): pojedinacna sedista ili sva
+    std::vector<int> changedSeats;
+    bool refreshedAll;
+
+    SeatRenderer() : lastUpdatedSeats(0), refreshedAll(false), vao(0), instanceVBO(0), seatCount(0), fullRefresh(true) {}
+
+    // quadVBO je zajednicki jedinicni kvadrat iz Main.cpp (pozicija + UV)
+    void init(unsigned int quadVBO, const SeatTable& table, SeatEventStream& stream) {
+        seatCount = (int)table.seats.size();
+        instances.resize(seatCount);
+        for (int i = 0; i < seatCount; i++) fillInstance(i, table.seats[i]);
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &instanceVBO);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(SeatInstance), instances.data(), GL_DYNAMIC_DRAW);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SeatInstance), (void*)0);
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SeatInstance), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+
+        glBindVertexArray(0);
+        subscriber.subscribe(stream);
+        fullRefresh = false;
+    }
+
+    // Preuzima promene iz toka i salje na GPU samo opseg izmenjenih sedista.
+    // Cita se iz snimka sale, i to samo dogadjaji koji su vec ukljuceni u taj snimak.
+    void update(const SeatTable& table, GlStateCache& gl) {
+        const std::vector<Seat>& seats = table.seats;
+        int lo = seatCount, hi = -1;
+        changedSeats.clear();
+        refreshedAll = false;
+        bool ok = subscriber.poll([&](const SeatEvent& e) {
+            if (e.seat == SEAT_EVENT_ALL || (int)e.seat >= seatCount) {
+                fullRefresh = true;
+                return;
+            }
+            fillInstance(e.seat, seats[e.seat]);
+            changedSeats.push_back((int)e.seat);
+            if ((int)e.seat < lo) lo = e.seat;
+            if ((int)e.seat > hi) hi = e.seat;
+        }, table.eventPosition);
+        if (!ok) fullRefresh = true;
+
+        lastUpdatedSeats = 0;
+        if (fullRefresh || hi >= lo) gl.bindArrayBuffer(instanceVBO);
+        if (fullRefresh) {
+            for (int i = 0; i < seatCount; i++) fillInstance(i, seats[i]);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, seatCount * sizeof(SeatInstance), instances.data());
+            lastUpdatedSeats = seatCount;
+            refreshedAll = true;
+            fullRefresh = false;
+        }
+        else if (hi >= lo) {
+            glBufferSubData(GL_ARRAY_BUFFER, lo * sizeof(SeatInstance), (hi - lo + 1) * sizeof(SeatInstance), &instances[lo]);
+            lastUpdatedSeats = hi - lo + 1;
+        }
+    }
+
+    // Sedista nemaju teksturu (atribut UV nije ukljucen, pa je velicina dela teksture 0)
+    void draw(GlStateCache& gl, int uInstancedLoc) {
+        gl.uniform1i(uInstancedLoc, 1);
+        gl.bindVertexArray(vao);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, seatCount);
+    }
+
+    void destroy() {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &instanceVBO);
+    }
+
+private:
+    struct SeatInstance {
+        float x, y, w, h;
+        float r, g, b, a;
+    };
+
+    unsigned int vao;
+    unsigned int instanceVBO;
+    int seatCount;
+    bool fullRefresh;
+    std::vector<SeatInstance> instances;
+    SeatEventSubscriber subscriber;
+
+    void fillInstance(int i, const Seat& s) {
+        SeatInstance& inst = instances[i];
+        inst.x = s.x; inst.y = s.y; inst.w = s.width; inst.h = s.height;
+        inst.a = 1.0f;
+        if (s.state == RESERVED) { inst.r = 1.0f; inst.g = 1.0f; inst.b = 0.0f; }
+        else if (s.state == SOLD) { inst.r = 0.8f; inst.g = 0.0f; inst.b = 0.0f; }
+        else { inst.r = 0.0f; inst.g = 0.6f; inst.b = 1.0f; }
+    }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+#ifndef SEAT_SHARED_MAP_H
+#define SEAT_SHARED_MAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SeatEventStream.h"
+
+class SeatManager;
+struct Seat;
+
+// Raspored deljene memorije: zaglavlje, pa niz sedista.
+// sequence je seqlock brojac: neparan dok pisac menja podatke, paran kad su konzistentni.
+struct SharedSeatMapHeader {
+    uint32_t magic;
+    uint32_t seatCount;
+    std::atomic<uint32_t> sequence;
+    uint32_t reserved;
+    uint64_t version; // broj objavljenih promena (za citaoce koji hoce da preskoce nepromenjenu mapu)
+};
+
+struct SharedSeat {
+    float x, y, width, height;
+    uint32_t state;
+};
+
+// Jedini pisac: proces kioska koji drzi SeatManager.
+// Nikad ne ceka citaoce - samo poveca brojac, upise promene i ponovo poveca brojac.
+class SeatSharedMapWriter {
+public:
+    SeatSharedMapWriter();
+    ~SeatSharedMapWriter();
+
+    bool create(const std::string& name, const SeatManager& sm, SeatEventStream& stream);
+    void close();
+    bool isOpen() const { return header != NULL; }
+
+    // Upisuje u deljenu memoriju samo sedista koja su stigla kroz tok promena
+    void publish(const SeatManager& sm);
+
+private:
+    std::string name;
+    SharedSeatMapHeader* header;
+    SharedSeat* seats;
+    size_t mappedSize;
+    void* handle;
+    SeatEventSubscriber subscriber;
+    std::vector<uint32_t> dirty;
+};
+
+// Citalac: drugi proces na istom racunaru (npr. displej ispred sale)
+class SeatSharedMapReader {
+public:
+    uint64_t retries = 0;
+    bool stalled = false; // poslednje citanje je odustalo: pisac je stao usred upisa ili je pao
+
+    SeatSharedMapReader();
+    ~SeatSharedMapReader();
+
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return header != NULL; }
+
+    uint32_t seatCount() const { return header ? header->seatCount : 0; }
+
+    // Konzistentan snimak: kopira stanja i ponavlja citanje ako je pisac u meduvremenu menjao mapu.
+    // Vraca false ako se mapa nije promenila od poslednjeg citanja, ili ako pisac predugo
+    // drzi mapu usred upisa (tada je postavljen stalled, a out ostaje nepromenjen).
+    bool read(std::vector<Seat>& out);
+
+private:
+    SharedSeatMapHeader* header;
+    const SharedSeat* seats;
+    size_t mappedSize;
+    void* handle;
+    uint64_t lastVersion;
+    std::vector<Seat> scratch;
+};
+
+#endif
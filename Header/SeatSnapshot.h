@@ -0,0 +1,127 @@
+#pragma once
+#ifndef SEAT_SNAPSHOT_H
+#define SEAT_SNAPSHOT_H
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "SeatManager.h"
+
+// Nepromenljiv snimak sale: sta renderer i spawnPeople vide dok neko drugi menja sedista
+struct SeatTable {
+    uint64_t version;        // SeatManager::version u trenutku objave
+    uint64_t eventPosition;  // koliko dogadjaja iz toka promena je ukljuceno u ovaj snimak
+    std::vector<Seat> seats;
+};
+
+// Verzionisana tabela sedista (RCU): pisci prave novu verziju u slobodnoj tabeli i
+// atomicno je objave, citaoci samo procitaju indeks trenutne tabele - bez zakljucavanja.
+//
+// Svaki citalac ima svoj slot u kome objavi koju tabelu trenutno cita. Pisac ponovo koristi
+// samo tabele koje nisu trenutne i koje nijedan citalac nije objavio, pa je dovoljno
+// MAX_READERS + 2 tabele: nikad ne raste memorija i pisac nikad ne ceka citaoce.
+class SeatSnapshotStore {
+public:
+    enum { MAX_READERS = 4, TABLE_COUNT = MAX_READERS + 2, NONE = -1 };
+
+    // Pisci (glavna petlja, servis za rezervacije na svojoj niti) se medjusobno iskljucuju ovim
+    // mutex-om dok menjaju SeatManager i objavljuju novu verziju; citaoci ga nikad ne zakljucavaju.
+    std::mutex writerMutex;
+
+    uint64_t publishedVersions = 0;
+
+    SeatSnapshotStore() {
+        current.store(NONE);
+        for (int i = 0; i < MAX_READERS; i++) readers[i].store(NONE);
+        readerCount.store(0);
+    }
+
+    // publish() mora biti pozvan bar jednom pre prvog citanja.
+    // Svaka nit koja cita dobija svoj slot (jednom, pri pokretanju)
+    int registerReader() {
+        int slot = readerCount.fetch_add(1);
+        if (slot >= MAX_READERS) {
+            std::cout << "GRESKA: nema slobodnog slota za citaoca snimka sale (najvise " << MAX_READERS << ")" << std::endl;
+            assert(!"SeatSnapshotStore: previse citalaca");
+            return NONE;
+        }
+        return slot;
+    }
+
+    // Poziva se pod writerMutex-om. Ne radi nista ako se sedista nisu menjala od poslednje objave.
+    void publish(const SeatManager& sm) {
+        int cur = current.load();
+        if (cur != NONE && tables[cur].version == sm.version) return;
+
+        int target = findFreeTable(cur);
+        SeatTable& t = tables[target];
+        t.version = sm.version;
+        t.eventPosition = sm.events ? sm.events->published() : 0;
+        t.seats.assign(sm.seats.begin(), sm.seats.end()); // kapacitet ostaje, nema nove alokacije
+
+        current.store(target);
+        publishedVersions++;
+    }
+
+    // Drzi snimak zakljucan za citaoca dok postoji
+    class ReadGuard {
+    public:
+        ReadGuard(SeatSnapshotStore* s, int slot, const SeatTable* t) : store(s), slot(slot), table(t) {}
+        ReadGuard(std::unique_lock<std::mutex>&& l, const SeatTable* t) : store(NULL), slot(NONE), table(t), lock(std::move(l)) {}
+        ReadGuard(ReadGuard&& other) : store(other.store), slot(other.slot), table(other.table), lock(std::move(other.lock)) { other.store = NULL; }
+        ~ReadGuard() { if (store && slot != NONE) store->readers[slot].store(NONE); }
+
+        const SeatTable* operator->() const { return table; }
+        const SeatTable& operator*() const { return *table; }
+
+    private:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        SeatSnapshotStore* store;
+        int slot;
+        const SeatTable* table;
+        std::unique_lock<std::mutex> lock; // samo bez slota: pisac ne moze da menja tabele dok citamo
+    };
+
+    // Bez zakljucavanja: objavimo indeks koji citamo, pa proverimo da je i dalje trenutni.
+    // Ako se u meduvremenu promenio, pisac mozda nije video nasu objavu - pokusavamo ponovo.
+    // Bez ispravnog slota nema gde da se objavi sta citamo, pa se cita pod writerMutex-om (sporije, ali bezbedno).
+    ReadGuard read(int readerSlot) {
+        if (readerSlot < 0 || readerSlot >= MAX_READERS) {
+            std::unique_lock<std::mutex> l(writerMutex);
+            return ReadGuard(std::move(l), &tables[current.load()]);
+        }
+        while (true) {
+            int cur = current.load();
+            readers[readerSlot].store(cur);
+            if (current.load() == cur) return ReadGuard(this, readerSlot, &tables[cur]);
+        }
+    }
+
+private:
+    SeatTable tables[TABLE_COUNT];
+    std::atomic<int> current;
+    std::atomic<int> readers[MAX_READERS];
+    std::atomic<int> readerCount;
+
+    int findFreeTable(int cur) {
+        for (int i = 0; i < TABLE_COUNT; i++) {
+            if (i == cur) continue;
+            bool pinned = false;
+            for (int r = 0; r < MAX_READERS; r++) {
+                if (readers[r].load() == i) {
+                    pinned = true;
+                    break;
+                }
+            }
+            if (!pinned) return i;
+        }
+        return cur == 0 ? 1 : 0; // ne moze se desiti: citalaca ima najvise MAX_READERS
+    }
+};
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Razvojni rezim: prati fajlove sejdera i javlja kada se neki promeni, da bi se program ponovo
+// preveo bez restarta. Na Linux-u preko inotify (direktorijum fajla, jer editori cesto pisu novi
+// fajl i preimenuju ga), inace poredjenjem velicine i vremena izmene svakih pollInterval sekundi.
+class ShaderWatcher {
+public:
+    double pollInterval = 0.25;
+
+    ShaderWatcher();
+    ~ShaderWatcher();
+
+    bool watch(const std::vector<std::string>& files);
+    void close();
+    bool isOpen() const { return opened; }
+
+    // Da li se neki od fajlova promenio od proslog poziva; ne blokira
+    bool changed(double now);
+
+private:
+    std::vector<std::string> files;
+    bool opened;
+    int fd;                          // inotify (-1 kada se ne koristi)
+    std::vector<uint64_t> sizes;
+    std::vector<int64_t> mtimes;
+    double lastPoll;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#pragma once
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "TextureAtlas.h"
+#include "GlStateCache.h"
+
+enum SpriteBlend {
+    BLEND_ALPHA,  // providnost (glBlendFunc iz Main.cpp)
+    BLEND_OPAQUE  // bez mesanja
+};
+
+// Brojaci za jedan frejm (od poslednjeg begin)
+struct SpriteBatchStats {
+    int quads = 0;
+    int draws = 0;
+    size_t bytes = 0; // poslato na GPU
+};
+
+// Skuplja pravougaonike (pozicija, velicina, boja, deo teksture) umesto da se svaki crta svojim
+// uniformama i pozivom. prepare ih sortira po (sloj, mesanje, tekstura) i salje jednim upisom u
+// bafer koji se puni u krug; submit crta instancirano - jedan poziv za svaki niz iste teksture i mesanja.
+//
+// Slojevi cuvaju redosled crtanja (grupa iz kasnijeg sloja je uvek iznad); unutar sloja se
+// pravougaonici mogu preurediti po teksturi. Pravougaonik bez teksture ide uz bilo koju teksturu,
+// pa se npr. platno i vrata iz atlasa crtaju jednim pozivom.
+class SpriteBatch {
+public:
+    int layer = 0;
+    SpriteBlend blend = BLEND_ALPHA;
+    SpriteBatchStats frame;
+
+    // quadVBO je zajednicki jedinicni kvadrat iz Main.cpp (pozicija + UV)
+    void init(unsigned int quadVBO, int uInstancedLoc, size_t capacity = 4096) {
+        this->uInstancedLoc = uInstancedLoc;
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &instanceVBO);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        reserveBuffer(capacity * sizeof(QuadInstance));
+        for (int a = 2; a <= 4; a++) {
+            glEnableVertexAttribArray(a);
+            glVertexAttribDivisor(a, 1);
+        }
+        glBindVertexArray(0);
+    }
+
+    // Novi frejm; skupljeno u proslom ostaje za poredjenje (forEachChanged)
+    void begin() {
+        frame = SpriteBatchStats();
+        layer = 0;
+        blend = BLEND_ALPHA;
+        previous.swap(quads);
+        previousKeys.swap(keys);
+        quads.clear();
+        keys.clear();
+        splits.clear();
+        runs.clear();
+    }
+
+    // Posle ponovnog ucitavanja sejdera lokacija uniforme moze da se promeni
+    void setInstancedLocation(int loc) { uInstancedLoc = loc; }
+
+    // Sledeca grupa se crta preko svega do sada
+    void nextLayer() { layer++; }
+
+    // Sprajt bez teksture (Sprite()) crta se samo bojom
+    void draw(const Sprite& s, float x, float y, float w, float h, float r, float g, float b, float a) {
+        QuadInstance q;
+        q.x = x; q.y = y; q.w = w; q.h = h;
+        q.r = r; q.g = g; q.b = b; q.a = a;
+        bool textured = s.texture != 0;
+        q.u = s.u; q.v = s.v;
+        q.du = textured ? s.du : 0.0f; // du = 0: shader ne cita teksturu
+        q.dv = textured ? s.dv : 0.0f;
+        quads.push_back(q);
+        keys.push_back((uint64_t)layer << 40 | (uint64_t)blend << 32 | s.texture);
+    }
+
+    void drawRect(float x, float y, float w, float h, float r, float g, float b, float a) {
+        draw(Sprite(), x, y, w, h, r, g, b, a);
+    }
+
+    // Kraj dela frejma: ono sto se crta izmedju dva dela (npr. sedista) ne ide kroz batch
+    void split() {
+        splits.push_back(++layer);
+    }
+
+    // Sortira skupljeno i salje jednim upisom na GPU; posle toga se delovi crtaju sa submit
+    // (i vise puta, npr. za svaki prljav deo ekrana)
+    void prepare(GlStateCache& gl) {
+        size_t n = quads.size();
+        runs.clear();
+        if (n == 0) return;
+
+        // Sortira se samo ako vec nije po redu (obicno svaka grupa ima jednu teksturu).
+        // Slojevi rastu, pa sortiranje ne mesa delove.
+        if (!std::is_sorted(keys.begin(), keys.end())) {
+            order.resize(n);
+            for (size_t i = 0; i < n; i++) order[i] = (uint32_t)i;
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+            sorted.resize(n);
+            sortedKeys.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                sorted[i] = quads[order[i]];
+                sortedKeys[i] = keys[order[i]];
+            }
+            quads.swap(sorted);
+            keys.swap(sortedKeys);
+        }
+
+        // Upis u bafer u krug; kada nema mesta, stari sadrzaj se napusta (drajver daje novi bafer
+        // dok GPU jos crta iz starog), pa upis nikad ne ceka na GPU
+        size_t bytes = n * sizeof(QuadInstance);
+        gl.bindArrayBuffer(instanceVBO);
+        if (bytes > bufferSize) reserveBuffer(std::max(bytes, bufferSize * 2));
+        else if (bufferOffset + bytes > bufferSize) {
+            glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW);
+            bufferOffset = 0;
+        }
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, bufferOffset, bytes,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst == NULL) return;
+        memcpy(dst, quads.data(), bytes);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        frame.quads += (int)n;
+        frame.bytes += bytes;
+
+        // Nizovi: isti deo, isto mesanje i ista tekstura (bez teksture ide uz bilo koju)
+        size_t segment = 0;
+        for (size_t start = 0; start < n;) {
+            while (segment < splits.size() && (int)(keys[start] >> 40) >= splits[segment]) segment++;
+            Run run;
+            run.first = bufferOffset + start * sizeof(QuadInstance);
+            run.segment = (int)segment;
+            run.blend = (int)(keys[start] >> 32 & 0xff);
+            run.texture = 0;
+            size_t end = start;
+            for (; end < n; end++) {
+                int l = (int)(keys[end] >> 40);
+                int b = (int)(keys[end] >> 32 & 0xff);
+                unsigned int t = (unsigned int)(keys[end] & 0xffffffffu);
+                if (b != run.blend || (t != 0 && run.texture != 0 && t != run.texture)) break;
+                if (segment < splits.size() && l >= splits[segment]) break;
+                if (t != 0) run.texture = t;
+            }
+            run.count = (int)(end - start);
+            runs.push_back(run);
+            start = end;
+        }
+        bufferOffset += bytes;
+    }
+
+    // Crta jedan deo frejma (0 = do prvog split, ...)
+    void submit(GlStateCache& gl, int segment) {
+        bool bound = false;
+        for (const Run& run : runs) {
+            if (run.segment != segment) continue;
+            if (!bound) {
+                gl.bindVertexArray(vao);
+                gl.uniform1i(uInstancedLoc, 1);
+                bound = true;
+            }
+            gl.setBlend(run.blend == BLEND_ALPHA);
+            if (run.texture != 0) gl.bindTexture(0, run.texture);
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)run.first);
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)(run.first + 4 * sizeof(float)));
+            glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)(run.first + 8 * sizeof(float)));
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, run.count);
+            frame.draws++;
+        }
+    }
+
+    // Broj poziva za crtanje celog frejma jednom
+    int runCount() const { return (int)runs.size(); }
+
+    // Za svaki pravougaonik koji se promenio od prethodnog frejma (po redosledu posle sortiranja):
+    // f(x, y, w, h) i za staru i za novu poziciju. Poziva se posle prepare.
+    template <typename F>
+    void forEachChanged(F f) const {
+        size_t common = std::min(quads.size(), previous.size());
+        for (size_t i = 0; i < common; i++) {
+            const QuadInstance& a = quads[i];
+            const QuadInstance& b = previous[i];
+            if (memcmp(&a, &b, sizeof(QuadInstance)) == 0 && keys[i] == previousKeys[i]) continue;
+            f(b.x, b.y, b.w, b.h);
+            f(a.x, a.y, a.w, a.h);
+        }
+        for (size_t i = common; i < quads.size(); i++) f(quads[i].x, quads[i].y, quads[i].w, quads[i].h);
+        for (size_t i = common; i < previous.size(); i++) f(previous[i].x, previous[i].y, previous[i].w, previous[i].h);
+    }
+
+    void destroy() {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &instanceVBO);
+    }
+
+private:
+    // Jedna instanca: pravougaonik, boja i deo teksture (isti raspored kao atributi 2-4 u basic.vert)
+    struct QuadInstance {
+        float x, y, w, h;
+        float r, g, b, a;
+        float u, v, du, dv;
+    };
+
+    unsigned int vao = 0;
+    unsigned int instanceVBO = 0;
+    int uInstancedLoc = -1;
+    size_t bufferSize = 0;
+    size_t bufferOffset = 0;
+
+    // Niz uzastopnih instanci u baferu koje se crtaju jednim pozivom
+    struct Run {
+        size_t first; // bajt u baferu
+        int count;
+        int segment;
+        int blend;
+        unsigned int texture;
+    };
+
+    std::vector<QuadInstance> quads, sorted, previous;
+    std::vector<uint64_t> keys, sortedKeys, previousKeys; // sloj << 40 | mesanje << 32 | tekstura
+    std::vector<uint32_t> order;
+    std::vector<int> splits; // prvi sloj svakog sledeceg dela
+    std::vector<Run> runs;
+
+    void reserveBuffer(size_t bytes) {
+        bufferSize = bytes;
+        bufferOffset = 0;
+        glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW);
+    }
+};
+
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Statistike koje se racunaju u prolazu, bez cuvanja uzoraka (memorija ne raste sa brojem merenja)
+
+// Srednja vrednost i varijansa (Welford), min/max i poluprecnik intervala poverenja za srednju vrednost
+class RunningStats {
+public:
+    void add(double x) {
+        n++;
+        double delta = x - avg;
+        avg += delta / n;
+        m2 += delta * (x - avg);
+        if (n == 1 || x < lo) lo = x;
+        if (n == 1 || x > hi) hi = x;
+    }
+
+    uint64_t count() const { return n; }
+    double mean() const { return avg; }
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return lo; }
+    double max() const { return hi; }
+
+    // z * s / sqrt(n); z = 1.96 za 95% (normalna aproksimacija, ima smisla od ~30 uzoraka)
+    double halfWidth(double z) const {
+        return n > 1 ? z * std::sqrt(variance() / n) : 0.0;
+    }
+
+private:
+    uint64_t n = 0;
+    double avg = 0.0;
+    double m2 = 0.0;
+    double lo = 0.0, hi = 0.0;
+};
+
+// Procena jednog kvantila algoritmom P^2 (Jain i Chlamtac): pet markera umesto svih uzoraka.
+// Markeri se pomeraju parabolicnom interpolacijom kako stizu novi uzorci.
+class P2Quantile {
+public:
+    explicit P2Quantile(double quantile = 0.5) : p(quantile) {}
+
+    void add(double x) {
+        if (n < 5) {
+            q[n++] = x;
+            if (n == 5) {
+                std::sort(q, q + 5);
+                for (int i = 0; i < 5; i++) pos[i] = i + 1;
+                desired[0] = 1.0;
+                desired[1] = 1.0 + 2.0 * p;
+                desired[2] = 1.0 + 4.0 * p;
+                desired[3] = 3.0 + 2.0 * p;
+                desired[4] = 5.0;
+                step[0] = 0.0;
+                step[1] = p / 2.0;
+                step[2] = p;
+                step[3] = (1.0 + p) / 2.0;
+                step[4] = 1.0;
+            }
+            return;
+        }
+
+        // Interval [q[k], q[k+1]) u koji pada uzorak; krajnji markeri prate min i max
+        int k;
+        if (x < q[0]) {
+            q[0] = x;
+            k = 0;
+        }
+        else if (x >= q[4]) {
+            q[4] = x;
+            k = 3;
+        }
+        else {
+            k = 0;
+            while (x >= q[k + 1]) k++;
+        }
+        for (int i = k + 1; i < 5; i++) pos[i]++;
+        for (int i = 0; i < 5; i++) desired[i] += step[i];
+        n++;
+
+        for (int i = 1; i <= 3; i++) {
+            double d = desired[i] - pos[i];
+            if ((d >= 1.0 && pos[i + 1] - pos[i] > 1) || (d <= -1.0 && pos[i - 1] - pos[i] < -1)) {
+                int s = d >= 0.0 ? 1 : -1;
+                double candidate = parabolic(i, s);
+                if (q[i - 1] < candidate && candidate < q[i + 1]) q[i] = candidate;
+                else q[i] = q[i] + s * (q[i + s] - q[i]) / (pos[i + s] - pos[i]);
+                pos[i] += s;
+            }
+        }
+    }
+
+    double value() const {
+        if (n >= 5) return q[2];
+        if (n == 0) return 0.0;
+        // Manje od pet uzoraka: tacan kvantil
+        double sorted[5];
+        std::copy(q, q + n, sorted);
+        std::sort(sorted, sorted + n);
+        return sorted[(int)(p * (n - 1) + 0.5)];
+    }
+
+    double quantile() const { return p; }
+    uint64_t count() const { return n; }
+
+private:
+    double p;
+    uint64_t n = 0;
+    double q[5] = {};       // visine markera
+    int pos[5] = {};        // stvarne pozicije markera
+    double desired[5] = {}; // zeljene pozicije
+    double step[5] = {};    // pomeraj zeljenih pozicija po uzorku
+
+    double parabolic(int i, int s) const {
+        double a = (double)(pos[i] - pos[i - 1] + s) * (q[i + 1] - q[i]) / (pos[i + 1] - pos[i]);
+        double b = (double)(pos[i + 1] - pos[i] - s) * (q[i] - q[i - 1]) / (pos[i] - pos[i - 1]);
+        return q[i] + (double)s / (pos[i + 1] - pos[i - 1]) * (a + b);
+    }
+};
+
+#endif
@@ -0,0 +1,187 @@
+#pragma once
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sprajt: tekstura i pravougaonik u njoj (UV pocetak i velicina). Pojedinacna tekstura je
+// sprajt preko cele slike; u atlasu svi sprajtovi dele istu teksturu.
+struct Sprite {
+    unsigned int texture = 0;
+    float u = 0.0f, v = 0.0f, du = 1.0f, dv = 1.0f;
+};
+
+// Pakovanje pravougaonika "skyline" metodom: pamti se samo gornja ivica zauzetog dela (niz
+// vodoravnih segmenata), a svaki novi pravougaonik ide na najnize mesto (pa najlevlje) gde staje.
+class SkylinePacker {
+public:
+    void init(int width, int height) {
+        this->width = width;
+        this->height = height;
+        skyline.clear();
+        skyline.push_back(Segment{ 0, 0, width });
+    }
+
+    bool insert(int w, int h, int& x, int& y) {
+        int bestY = height, bestIndex = -1;
+        for (size_t i = 0; i < skyline.size(); i++) {
+            int top = fitAt(i, w, h);
+            if (top >= 0 && top < bestY) {
+                bestY = top;
+                bestIndex = (int)i;
+            }
+        }
+        if (bestIndex < 0) return false;
+        x = skyline[bestIndex].x;
+        y = bestY;
+        place(bestIndex, x, y + h, w);
+        return true;
+    }
+
+private:
+    struct Segment {
+        int x, y, width;
+    };
+
+    int width = 0, height = 0;
+    std::vector<Segment> skyline;
+
+    // Najniza visina na kojoj pravougaonik pocinje na segmentu i; -1 ako ne staje
+    int fitAt(size_t i, int w, int h) const {
+        if (skyline[i].x + w > width) return -1;
+        int top = 0, remaining = w;
+        for (size_t j = i; remaining > 0; j++) {
+            if (j == skyline.size()) return -1;
+            top = std::max(top, skyline[j].y);
+            remaining -= skyline[j].width;
+        }
+        return top + h <= height ? top : -1;
+    }
+
+    // Novi segment (x, top, w) prekriva sve sto je ispod njega
+    void place(int index, int x, int top, int w) {
+        skyline.insert(skyline.begin() + index, Segment{ x, top, w });
+        size_t i = index + 1;
+        while (i < skyline.size() && skyline[i].x < x + w) {
+            int overlap = x + w - skyline[i].x;
+            if (overlap >= skyline[i].width) {
+                skyline.erase(skyline.begin() + i);
+                continue;
+            }
+            skyline[i].x += overlap;
+            skyline[i].width -= overlap;
+            break;
+        }
+        // Susedi iste visine se spajaju
+        for (size_t j = 0; j + 1 < skyline.size();) {
+            if (skyline[j].y == skyline[j + 1].y) {
+                skyline[j].width += skyline[j + 1].width;
+                skyline.erase(skyline.begin() + j + 1);
+            }
+            else j++;
+        }
+    }
+};
+
+// Jedna slika u atlasu: mesto i velicina (sa okvirom) su poznati pre dekodiranja
+struct AtlasSlot {
+    int index;                   // indeks u listi slika iz start/build
+    std::string file;
+    int width, height;
+    int slotWidth, slotHeight;   // sa okvirom, poravnato
+    int x, y;
+    std::vector<unsigned char> pixels; // ceo pravougaonik sa okvirom, spreman za slanje (radna nit)
+};
+
+// Sve slike sprajtova u jednoj teksturi: ceo frejm se crta sa jednom vezanom teksturom.
+// Oko svake slike je okvir od 2^maxLevel piksela popunjen ivicnim pikselima, a pocetak i velicina
+// su poravnati na 2^maxLevel, pa ni mipmape do nivoa maxLevel ne mesaju susedne slike.
+//
+// Ucitavanje je asinhrono: raspored se pravi odmah iz zaglavlja slika, tekstura se popuni
+// zamenskom bojom, a slike dekodiraju radne niti. poll (na GL niti, svakog frejma) salje gotove
+// slike kroz pixel buffer, pa se prvi frejm crta odmah, sa zamenom umesto slika koje jos stizu.
+class TextureAtlas {
+public:
+    unsigned int texture = 0;
+    int width = 0, height = 0;
+    int maxLevel = 4;
+    float placeholder[4] = { 0.5f, 0.5f, 0.5f, 0.35f }; // boja dok slika ne stigne
+
+    // Poziva se sa radne niti kada je slika dekodirana (npr. glfwPostEmptyEvent da se petlja probudi)
+    std::function<void()> onDecoded;
+
+    // Statistika (sekunde)
+    int threadsUsed = 0;
+    double decodeTime = 0.0;  // zbir dekodiranja po svim nitima
+    double readyTime = 0.0;   // od start do poslednje poslate slike
+
+    TextureAtlas() : nextSlot(0) {}
+    ~TextureAtlas() { joinWorkers(); }
+
+    // Sinhrono (kao ranije): vraca se tek kada su sve slike u teksturi.
+    // Slike koje ne postoje se preskacu (njihov sprajt nema teksturu); false ako nijedna nije ucitana
+    bool build(const std::vector<std::string>& files) {
+        if (!start(files, 1)) return false;
+        finish();
+        return true;
+    }
+
+    // Asinhrono: sprajtovi su ispravni odmah po povratku, a slike stizu preko poll.
+    // threads <= 0: onoliko niti koliko ima jezgara (ne vise nego slika)
+    bool start(const std::vector<std::string>& files, int threads = 0);
+
+    // Salje na GPU slike dekodirane od proslog poziva (GL nit); vraca koliko ih je poslato.
+    // Menja vezanu teksturu i GL_PIXEL_UNPACK_BUFFER mimo GlStateCache.
+    int poll();
+
+    // Ceka i salje sve preostale slike
+    void finish();
+
+    bool loading() const { return pending > 0; }
+
+    // Paket slika (AssetPack.h): alat ga pravi unapred (raspored, obrtanje, okvir i mipmape), a pri
+    // pokretanju se fajl samo mapira i nivoi idu na GPU direktno iz mapirane memorije.
+    // writePack ne koristi GL; maxSize je najveca tekstura koju atlas sme da zauzme.
+    bool writePack(const std::string& path, const std::vector<std::string>& files, int maxSize = 8192);
+
+    // false (atlas ostaje prazan) ako paketa nema, ako nije ispravan, ako je neka od slika na disku
+    // novija od paketa ili je nema u paketu - tada se slike ucitavaju sa start/build
+    bool loadPack(const std::string& path, const std::vector<std::string>& files);
+
+    // Sprajt za sliku (po putanji iz build); bez teksture ako slika nije u atlasu
+    Sprite sprite(const std::string& file) const {
+        for (size_t i = 0; i < names.size(); i++) {
+            if (names[i] == file) return sprites[i];
+        }
+        return Sprite();
+    }
+
+private:
+    std::vector<std::string> names;
+    std::vector<Sprite> sprites;
+
+    std::vector<AtlasSlot> slots;
+    std::vector<std::thread> workers;
+    std::atomic<int> nextSlot;        // sledeca slika za dekodiranje
+    std::mutex doneMutex;
+    std::condition_variable decoded;
+    std::vector<int> done;            // dekodirane, a jos neposlate (pod doneMutex)
+    int pending = 0;                  // neposlate (samo GL nit)
+    unsigned int pbo = 0;
+    double startTime = 0.0;
+
+    bool layout(const std::vector<std::string>& files, int maxSize);
+    void decodeSlot(AtlasSlot& slot) const;
+    void decodeWorker();
+    void joinWorkers();
+};
+
+#endif
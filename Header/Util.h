@@ -4,5 +4,7 @@
 #include <string>
 int endProgram(std::string message);
 unsigned int createShader(const char* vsSource, const char* fsSource);
+unsigned int createShaderFromFiles(const char* vsPath, const char* fsPath);
+void setShaderCacheDirectory(const std::string& directory);
 unsigned loadImageToTexture(const char* filePath);
 GLFWcursor* loadImageToCursor(const char* filePath);
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "../Header/AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef COUNT_ALLOCATIONS
+
+// Opis: globalni operator new/delete koji samo broje pozive i prosledjuju malloc/free.
+// new[] i nothrow varijante po standardu pozivaju ovaj operator new, pa se i one broje.
+
+static std::atomic<uint64_t> allocations(0);
+
+bool allocationCounterAvailable() {
+    return true;
+}
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#else
+
+// Bez brojaca: alokacije idu kroz standardni operator new
+bool allocationCounterAvailable() {
+    return false;
+}
+
+uint64_t allocationCount() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/ArrivalSchedule.h"
+
+#include <cstdio>
+#include <iostream>
+
+bool ArrivalSchedule::loadHistogram(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == NULL) {
+        std::cout << "GRESKA: Raspodela dolazaka ne postoji: " << path << std::endl;
+        return false;
+    }
+    histogram.clear();
+    float w;
+    while (fscanf(file, "%f", &w) == 1) {
+        if (w < 0.0f) w = 0.0f;
+        histogram.push_back(w);
+    }
+    fclose(file);
+    if (histogram.empty()) {
+        std::cout << "GRESKA: Raspodela dolazaka je prazna: " << path << std::endl;
+        return false;
+    }
+    mode = ARRIVE_HISTOGRAM;
+    return true;
+}
@@ -0,0 +1,82 @@
+#include "../Header/AssetPack.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& mtime) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    size = (uint64_t)st.st_size;
+    mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+MappedFile::MappedFile() {
+    data = NULL;
+    length = 0;
+    handle = NULL;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // mapiranje drzi fajl otvorenim
+    if (mapping == NULL) return false;
+    void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (p == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+    handle = mapping;
+    length = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    length = (size_t)st.st_size;
+#endif
+    data = (const unsigned char*)p;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data == NULL) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)handle);
+#else
+    munmap((void*)data, length);
+#endif
+    data = NULL;
+    length = 0;
+    handle = NULL;
+}
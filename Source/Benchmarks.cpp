@@ -0,0 +1,407 @@
+#include "../Header/Benchmarks.h"
+#include "../Header/SeatManager.h"
+#include "../Header/SeatJournal.h"
+#include "../Header/SeatEventStream.h"
+#include "../Header/PersonManager.h"
+#include "../Header/FlowField.h"
+#include "../Header/DoorAssignment.h"
+#include "../Header/AllocationCounter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Meri koliko promena stanja sedista u sekundi mozemo trajno da upisemo (sa fsync),
+// za razlicite velicine grupnog upisa, i koliko traje oporavak pri pokretanju.
+int runJournalBenchmark() {
+    const char* prefix = "bench_seats";
+    const double duration = 2.0;
+    const size_t batches[] = { 1, 16, 256 };
+
+    for (size_t batch : batches) {
+        SeatJournal journal;
+        journal.maxBatch = batch;
+        journal.maxDelay = 1e9; // upisuje se iskljucivo po velicini grupe
+        if (!journal.open(prefix)) return -1;
+
+        SeatManager sm;
+        sm.journal = &journal;
+        journal.recover(sm);
+
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t transitions = 0;
+        double elapsed = 0.0;
+        while (elapsed < duration) {
+            for (int k = 0; k < 64; k++) {
+                int index = (int)(transitions % sm.seats.size());
+                sm.setSeatState(index, sm.seats[index].state == FREE ? RESERVED : FREE);
+                transitions++;
+            }
+            elapsed = secondsSince(t0);
+            sm.flushJournal(elapsed);
+        }
+        journal.commit();
+        elapsed = secondsSince(t0);
+
+        std::cout << "Zurnal, grupa " << batch << ": " << (uint64_t)(transitions / elapsed) << " promena/s, "
+            << (uint64_t)(journal.syncCount / elapsed) << " fsync/s, "
+            << journal.checkpointCount << " checkpoint-a" << std::endl;
+    }
+
+    // Oporavak: checkpoint + rep zurnala od checkpointInterval - 1 zapisa (najgori slucaj)
+    {
+        SeatJournal journal;
+        journal.open(prefix);
+        SeatManager sm;
+        sm.journal = &journal;
+        journal.recover(sm);
+        for (uint32_t i = 0; i + 1 < journal.checkpointInterval; i++) {
+            int index = (int)(i % sm.seats.size());
+            sm.setSeatState(index, sm.seats[index].state == FREE ? SOLD : FREE);
+        }
+        journal.commit();
+    }
+    {
+        SeatJournal journal;
+        journal.open(prefix);
+        SeatManager sm;
+        auto t0 = std::chrono::steady_clock::now();
+        journal.recover(sm);
+        std::cout << "Oporavak: " << secondsSince(t0) * 1000.0 << " ms" << std::endl;
+    }
+
+    std::remove("bench_seats.journal");
+    std::remove("bench_seats.checkpoint");
+    return 0;
+}
+
+// Jedan proizvodjac i 4 pretplatnika na toku promena sedista.
+// Meri brzinu objavljivanja, koliko je dogadjaja svaki pretplatnik primio i koliko puta je zaostao.
+int runEventStreamBenchmark() {
+    const int consumers = 4;
+    const uint64_t total = 20000000;
+
+    SeatEventStream stream(1 << 16);
+    std::vector<SeatEventSubscriber> subs(consumers);
+    for (auto& s : subs) s.subscribe(stream);
+    std::vector<uint64_t> checksums(consumers, 0);
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c]() {
+            uint64_t sum = 0;
+            auto consume = [&](const SeatEvent& e) { sum += e.seat; };
+            while (!done.load(std::memory_order_acquire)) {
+                if (!subs[c].hasPending()) std::this_thread::yield();
+                subs[c].poll(consume);
+            }
+            subs[c].poll(consume);
+            checksums[c] = sum;
+        });
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < total; i++) {
+        stream.publish((uint32_t)(i % 72), FREE, RESERVED);
+        if ((i & 0xFFF) == 0) std::this_thread::yield();
+    }
+    double produceTime = secondsSince(t0);
+    done.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    double totalTime = secondsSince(t0);
+
+    std::cout << "Tok promena, 1 proizvodjac x " << consumers << " pretplatnika, "
+        << std::thread::hardware_concurrency() << " jezgara:" << std::endl;
+    std::cout << "  objavljeno: " << (uint64_t)(total / produceTime) << " dogadjaja/s" << std::endl;
+
+    // Bez zaostajanja pretplatnik je primio svaki dogadjaj tacno jednom: zbir sedista je poznat
+    uint64_t expected = (total / 72) * (71 * 72 / 2);
+    for (uint64_t i = 0; i < total % 72; i++) expected += i;
+    int failed = 0;
+    for (int c = 0; c < consumers; c++) {
+        std::cout << "  pretplatnik " << c << ": " << (uint64_t)(subs[c].received / totalTime) << " dogadjaja/s, primljeno "
+            << subs[c].received * 100.0 / total << "%, zaostajanja " << subs[c].overruns;
+        if (subs[c].overruns > 0) std::cout << " (kontrolni zbir se ne proverava)";
+        else if (checksums[c] == expected) std::cout << ", kontrolni zbir ispravan";
+        else {
+            std::cout << ", GRESKA: kontrolni zbir " << checksums[c] << " umesto " << expected;
+            failed++;
+        }
+        std::cout << std::endl;
+    }
+    return failed ? 1 : 0;
+}
+
+// Polje toka za veliku salu: izgradnja, delimicna popravka posle promene rasporeda
+// i cena jednog koraka po agentu za 100k agenata koji dele jedno polje.
+int runFlowFieldBenchmark() {
+    const int side = 316; // ~100k sedista
+    std::vector<Seat> seats;
+    seats.reserve(side * side);
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            Seat s;
+            s.x = -0.8f + c * (1.6f / side);
+            s.y = 0.5f - r * (1.4f / side);
+            s.width = 0.002f;
+            s.height = 0.002f;
+            s.state = SOLD;
+            seats.push_back(s);
+        }
+    }
+
+    HallNavigation nav;
+    auto t0 = std::chrono::steady_clock::now();
+    nav.build(seats, defaultDoorLayout(1), 0.005f);
+    double buildMs = secondsSince(t0) * 1000.0;
+    std::cout << "Polje toka: mreza " << nav.grid.width << "x" << nav.grid.height << ", izgradnja " << buildMs << " ms" << std::endl;
+
+    // Zatvaramo pa otvaramo jedan prolaz
+    t0 = std::chrono::steady_clock::now();
+    nav.setObstacle(-0.2f, -0.2f, 0.3f, 0.02f, true);
+    double blockMs = secondsSince(t0) * 1000.0;
+    int blockRelaxed = nav.doors[0].lastRelaxed, blockRelabeled = nav.doors[0].lastRelabeled;
+    t0 = std::chrono::steady_clock::now();
+    nav.setObstacle(-0.2f, -0.2f, 0.3f, 0.02f, false);
+    double unblockMs = secondsSince(t0) * 1000.0;
+    std::cout << "  popravka posle prepreke: " << blockMs << " ms (" << blockRelaxed << " celija, obilazak "
+        << blockRelabeled << "), posle uklanjanja: " << unblockMs << " ms (" << nav.doors[0].lastRelaxed
+        << " celija, obilazak " << nav.doors[0].lastRelabeled << ")" << std::endl;
+
+    PersonManager pm(false);
+    pm.nav = &nav;
+    pm.doors[0].headway = 0.0f; // meri se samo kretanje, bez reda na vratima
+    pm.spawnPeople(seats);
+
+    const double dt = 1.0 / 75.0;
+    int ticks = 0;
+    t0 = std::chrono::steady_clock::now();
+    while (!pm.areAllSeated() && ticks < 100000) {
+        pm.update(dt);
+        ticks++;
+    }
+    double enterTime = secondsSince(t0);
+    std::cout << "  " << pm.count() << " agenata, ulazak " << ticks << " tickova za " << enterTime << " s ("
+        << enterTime * 1e9 / ((double)ticks * pm.count()) << " ns po agentu po koraku)" << std::endl;
+    return 0;
+}
+
+// Ulazak i izlazak pune vece sale (po polju toka) sa 1-6 vrata, i poredjenje pohlepnog
+// rasporedjivanja sa tacnim (madjarskim) na originalnoj sali
+int runDoorBenchmark() {
+    const int side = 40;
+    std::vector<Seat> seats;
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            Seat s;
+            s.x = -0.7f + c * (1.4f / side);
+            s.y = 0.4f - r * (1.2f / side);
+            s.width = 0.02f;
+            s.height = 0.02f;
+            s.state = SOLD;
+            seats.push_back(s);
+        }
+    }
+
+    const double dt = 1.0 / 75.0;
+    for (int doorCount = 1; doorCount <= 6; doorCount++) {
+        PersonManager pm(false);
+        pm.doors = defaultDoorLayout(doorCount);
+        HallNavigation nav;
+        nav.build(seats, pm.doors, 0.01f);
+        pm.nav = &nav;
+
+        pm.rng.setSeed(1);
+        auto t0 = std::chrono::steady_clock::now();
+        pm.spawnPeople(seats);
+        double assignMs = secondsSince(t0) * 1000.0;
+        size_t count = pm.count();
+
+        int ticks = 0;
+        while (!pm.areAllSeated() && ticks < 100000) {
+            pm.update(dt);
+            ticks++;
+        }
+        float enterTime = pm.clock;
+        pm.startExit();
+        while (!pm.areAllGone() && ticks < 200000) {
+            pm.update(dt);
+            ticks++;
+        }
+        std::cout << doorCount << " vrata, " << count << " ljudi (rasporedjivanje " << assignMs << " ms, "
+            << (pm.assigner.lastOptimal ? "tacno" : "pohlepno") << "): ulazak " << enterTime << " s, izlazak " << pm.clock
+            << " s, obrt bez filma " << enterTime + pm.clock << " s" << std::endl;
+        pm.printDoorStats(true);
+    }
+
+    // Originalna sala (72 sedista): koliko pohlepno odstupa od optimuma
+    SeatManager sm;
+    std::vector<float> travel;
+    std::vector<int> doorOf, slotOf;
+    for (int doorCount = 2; doorCount <= 6; doorCount++) {
+        std::vector<Door> doors = defaultDoorLayout(doorCount);
+        int n = (int)sm.seats.size();
+        travel.resize(n * doorCount);
+        for (int i = 0; i < n; i++) {
+            for (int d = 0; d < doorCount; d++) {
+                const Seat& s = sm.seats[i];
+                travel[i * doorCount + d] = (std::fabs(doors[d].y - s.y) + std::fabs(doors[d].x - s.x)) / 0.45f;
+            }
+        }
+        DoorAssigner assigner;
+        assigner.optimalLimit = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        assigner.assign(travel, n, doors, doorOf, slotOf);
+        double greedyUs = secondsSince(t0) * 1e6;
+        double greedyCost = assigner.lastCost;
+        assigner.optimalLimit = n;
+        t0 = std::chrono::steady_clock::now();
+        assigner.assign(travel, n, doors, doorOf, slotOf);
+        double optimalUs = secondsSince(t0) * 1e6;
+        std::cout << "Sala 72 sedista, " << doorCount << " vrata: pohlepno " << greedyCost << " s (" << greedyUs
+            << " us), tacno " << assigner.lastCost << " s (" << optimalUs << " us)" << std::endl;
+    }
+    return 0;
+}
+
+// Vise uzastopnih projekcija (ulazak + izlazak) iste sale: posle prve, alokacija ne bi smelo da bude
+int runPersonPoolBenchmark() {
+    SeatManager sm;
+    for (Seat& s : sm.seats) s.state = SOLD;
+    PersonManager pm(false);
+    pm.doors = defaultDoorLayout(2);
+
+    const double dt = 1.0 / 75.0;
+    for (int cycle = 1; cycle <= 5; cycle++) {
+        uint64_t before = allocationCount();
+        pm.spawnPeople(sm.seats);
+        size_t count = pm.count();
+        while (!pm.areAllSeated()) pm.update(dt);
+        pm.startExit();
+        while (!pm.areAllGone()) pm.update(dt);
+        pm.clear();
+        std::cout << "Projekcija " << cycle << ": " << count << " ljudi, alokacija ";
+        if (allocationCounterAvailable()) std::cout << allocationCount() - before;
+        else std::cout << "nedostupno (build bez COUNT_ALLOCATIONS)";
+        std::cout << " (kapacitet skladista " << pm.people.capacity() << ", rast " << pm.people.growths << ")" << std::endl;
+    }
+    return 0;
+}
+
+// Kvadratna tribina side x side sedista, sva prodata
+static std::vector<Seat> stadiumSeats(int side) {
+    std::vector<Seat> seats;
+    seats.reserve(side * side);
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            Seat s;
+            s.x = -0.9f + c * (1.8f / side);
+            s.y = 0.5f - r * (1.3f / side);
+            s.width = 0.001f;
+            s.height = 0.001f;
+            s.state = SOLD;
+            seats.push_back(s);
+        }
+    }
+    return seats;
+}
+
+// Stadion sa milion sedista: isti ulazak sa punim i sa sazetim zapisom coveka
+int runCompactPersonBenchmark() {
+    std::vector<Seat> seats = stadiumSeats(1000);
+
+    const double dt = 1.0 / 75.0;
+    const int ticks = 200;
+    for (int compact = 0; compact <= 1; compact++) {
+        PersonManager pm(false);
+        pm.compact = compact != 0;
+        pm.doors = defaultDoorLayout(4);
+        for (Door& d : pm.doors) d.headway = 0.0f; // meri se samo kretanje
+
+        pm.rng.setSeed(1);
+        pm.spawnPeople(seats);
+        auto t0 = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) pm.update(dt);
+        double elapsed = secondsSince(t0);
+
+        std::cout << (compact ? "Sazet" : "Pun") << " zapis: " << pm.count() << " ljudi, " << ticks << " koraka za "
+            << elapsed << " s (" << elapsed * 1e9 / ((double)ticks * pm.count()) << " ns po coveku po koraku)" << std::endl;
+        pm.printMemoryFootprint();
+
+        // Ostatak ulaska i ceo izlazak: oba zapisa treba da daju ista vremena
+        while (!pm.areAllSeated()) pm.update(dt);
+        float enterTime = pm.clock;
+        pm.startExit();
+        while (!pm.areAllGone()) pm.update(dt);
+        std::cout << "  ulazak " << enterTime << " s, izlazak " << pm.clock << " s" << std::endl;
+    }
+    return 0;
+}
+
+// Stadion sa milion sedista, ceo ulazak i izlazak: svi pojedinacno, pa sa nivoom detalja
+// (pojedinacno samo u centru scene). Meri trajanje koraka i proverava da se vremena ne menjaju.
+int runLodBenchmark() {
+    std::vector<Seat> seats = stadiumSeats(1000);
+    const double dt = 1.0 / 75.0;
+
+    for (int lod = 0; lod <= 1; lod++) {
+        PersonManager pm(false);
+        pm.compact = true;
+        pm.lod = lod != 0;
+        pm.focus.x0 = pm.focus.y0 = -0.2f;
+        pm.focus.x1 = pm.focus.y1 = 0.2f;
+        pm.doors = defaultDoorLayout(4);
+        for (Door& d : pm.doors) d.headway = 0.0f;
+        pm.rng.setSeed(1);
+
+        // spawnPeople i startExit rade u jednom frejmu, pa se racunaju kao koraci
+        auto s0 = std::chrono::steady_clock::now();
+        pm.spawnPeople(seats);
+        double spawnTime = secondsSince(s0);
+        size_t spawned = pm.count();
+
+        double total = 0.0, worst = spawnTime, worstUpdate = 0.0, exitTime = 0.0;
+        int ticks = 0;
+        size_t peak = 0;
+        float phaseTime[2] = { 0.0f, 0.0f };
+        int passed[2] = { 0, 0 };
+        for (int phase = 0; phase < 2; phase++) {
+            if (phase == 1) {
+                auto e0 = std::chrono::steady_clock::now();
+                pm.startExit();
+                exitTime = secondsSince(e0);
+                worst = std::max(worst, exitTime);
+            }
+            while (phase == 0 ? !pm.areAllSeated() : !pm.areAllGone()) {
+                auto t0 = std::chrono::steady_clock::now();
+                pm.update(dt);
+                double elapsed = secondsSince(t0);
+                total += elapsed;
+                worst = std::max(worst, elapsed);
+                worstUpdate = std::max(worstUpdate, elapsed);
+                ticks++;
+                peak = std::max(peak, pm.compactPeople.size());
+            }
+            phaseTime[phase] = pm.clock;
+            for (const Door& d : pm.doors) passed[phase] += phase == 0 ? d.entered : d.exited;
+        }
+
+        std::cout << (lod ? "Nivo detalja" : "Svi pojedinacno") << ": " << spawned << " ljudi na " << seats.size()
+            << " sedista, najvise " << peak << " pojedinacno" << std::endl;
+        std::cout << "  korak prosecno " << total * 1000.0 / ticks << " ms, najduzi " << worst * 1000.0 << " ms ("
+            << ticks << " koraka)" << std::endl;
+        std::cout << "  spawnPeople " << spawnTime * 1000.0 << " ms, startExit " << exitTime * 1000.0
+            << " ms, najduzi update " << worstUpdate * 1000.0 << " ms" << std::endl;
+        std::cout << "  ulazak " << phaseTime[0] << " s, izlazak " << phaseTime[1] << " s (kroz vrata uslo " << passed[0]
+            << ", izaslo " << passed[1] << ")" << std::endl;
+    }
+    return 0;
+}
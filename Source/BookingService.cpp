@@ -0,0 +1,481 @@
+#include "../Header/BookingService.h"
+#include "../Header/SeatManager.h"
+#include "../Header/SeatJournal.h"
+#include "../Header/SeatSnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static bool fillAddress(sockaddr_un& addr, const std::string& socketPath) {
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cout << "GRESKA: Putanja socket-a je preduga: " << socketPath << std::endl;
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    return true;
+}
+
+BookingService::BookingService() {
+    listenFd = -1;
+    epollFd = -1;
+    snapshots = NULL;
+    writesOpen = NULL;
+    stopping = false;
+}
+
+BookingService::~BookingService() {
+    stop();
+}
+
+bool BookingService::startThread(SeatManager& sm, SeatSnapshotStore& store, std::atomic<bool>& acceptWrites) {
+    if (listenFd < 0) return false;
+    snapshots = &store;
+    writesOpen = &acceptWrites;
+    stopping = false;
+    worker = std::thread([this, &sm]() {
+        while (!stopping.load()) poll(sm, 50, true);
+    });
+    return true;
+}
+
+bool BookingService::start(const std::string& socketPath) {
+    sockaddr_un addr;
+    if (!fillAddress(addr, socketPath)) return false;
+
+    // Klijent koji nestane usred odgovora ne sme da obori servis
+    signal(SIGPIPE, SIG_IGN);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cout << "GRESKA: Socket nije napravljen: " << strerror(errno) << std::endl;
+        return false;
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 128) != 0) {
+        std::cout << "GRESKA: Socket nije vezan za " << socketPath << ": " << strerror(errno) << std::endl;
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    setNonBlocking(listenFd);
+
+    epollFd = epoll_create1(0);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+    path = socketPath;
+    std::cout << "Servis za rezervacije slusa na " << socketPath << std::endl;
+    return true;
+}
+
+void BookingService::stop() {
+    if (listenFd < 0) return;
+    stopping = true;
+    if (worker.joinable()) worker.join();
+    snapshots = NULL;
+    writesOpen = NULL;
+
+    for (auto& c : connections) close(c.first);
+    connections.clear();
+    close(listenFd);
+    close(epollFd);
+    unlink(path.c_str());
+    listenFd = -1;
+    epollFd = -1;
+}
+
+int BookingService::poll(SeatManager& sm, int timeoutMs, bool acceptWrites) {
+    if (listenFd < 0) return 0;
+
+    epoll_event events[64];
+    int n = epoll_wait(epollFd, events, 64, timeoutMs);
+
+    // 1. Pokupimo sve sto je stiglo u ovom ticku
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (fd == listenFd) {
+            acceptAll();
+            continue;
+        }
+        // Zahtevi poslati pre zatvaranja se i dalje obradjuju: prvo se procita sve sto je stiglo
+        if (events[i].events & (EPOLLIN | EPOLLHUP)) readAll(fd);
+        if ((events[i].events & EPOLLERR) && connections.count(fd)) {
+            closeConnection(fd);
+            continue;
+        }
+        if ((events[i].events & EPOLLOUT) && connections.count(fd)) flush(fd);
+    }
+    if (batch.empty()) return 0;
+
+    // Grupu preuzimamo lokalno, da zatvaranje konekcije pri slanju ne bi menjalo niz koji obilazimo
+    std::vector<Request> current;
+    current.swap(batch);
+
+    // Ako servis radi na svojoj niti, drugi pisci cekaju dok se cela grupa ne primeni
+    std::unique_lock<std::mutex> lock;
+    if (snapshots) lock = std::unique_lock<std::mutex>(snapshots->writerMutex);
+
+    // Stanje se proverava tek pod mutex-om: projekcija je mogla da pocne dok je poll cekao na zahteve
+    if (writesOpen) acceptWrites = acceptWrites && writesOpen->load();
+
+    // 2. Primena cele grupe odjednom
+    for (const Request& r : current) {
+        auto it = connections.find(r.fd);
+        if (it == connections.end()) continue;
+        std::string& out = it->second.out;
+        out += r.id;
+
+        if (!acceptWrites) out += " ERR BUSY\n";
+        else if (r.op == "RESERVE") out += sm.reserveSeat(r.arg) ? " OK\n" : " ERR TAKEN\n";
+        else if (r.op == "CANCEL") out += sm.cancelReservation(r.arg) ? " OK\n" : " ERR NOT_RESERVED\n";
+        else if (r.op == "BUY") {
+            int row = sm.buyTickets(r.arg);
+            out += row >= 0 ? " OK " + std::to_string(row + 1) + "\n" : " ERR NO_SPACE\n";
+        }
+        else out += " ERR UNKNOWN\n";
+    }
+
+    // 3. Jedan fsync za celu grupu, pa tek onda odgovori
+    if (sm.journal) {
+        sm.journal->commit();
+        if (sm.journal->wantsCheckpoint()) sm.journal->checkpoint(sm);
+    }
+    if (snapshots) {
+        snapshots->publish(sm);
+        lock.unlock();
+    }
+
+    int applied = (int)current.size();
+    if (onApplied) onApplied();
+    requestsServed += applied;
+    batchesApplied++;
+    largestBatch = std::max(largestBatch, current.size());
+
+    for (const Request& r : current) {
+        auto it = connections.find(r.fd);
+        if (it != connections.end() && !it->second.out.empty()) flush(r.fd);
+    }
+
+    // Vracamo isti niz (sa vec zauzetom memorijom) za sledeci tick
+    current.clear();
+    batch.swap(current);
+    return applied;
+}
+
+void BookingService::acceptAll() {
+    while (true) {
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) return;
+        setNonBlocking(fd);
+
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        connections[fd] = Connection();
+    }
+}
+
+void BookingService::readAll(int fd) {
+    auto it = connections.find(fd);
+    if (it == connections.end()) return;
+    Connection& c = it->second;
+
+    size_t queued = batch.size();
+    char buf[4096];
+    while (true) {
+        ssize_t got = read(fd, buf, sizeof(buf));
+        if (got > 0) {
+            c.in.append(buf, got);
+            parseLines(fd, c);
+            // Klijent koji nikad ne posalje kraj linije ne sme da raste memoriju servisa
+            if (c.in.size() > MAX_PENDING_INPUT) {
+                closeConnection(fd);
+                return;
+            }
+            continue;
+        }
+        if (got == 0) {
+            // Klijent je zavrsio slanje (shutdown ili close): odgovori na vec poslate zahteve
+            // idu pre zatvaranja, a dalje citanje se iskljucuje da epoll ne bi stalno javljao EOF
+            // (drugi EOF stize samo uz EPOLLHUP: klijent je potpuno otisao i odgovori nemaju kud)
+            if (batch.size() == queued && (c.out.empty() || c.peerClosed)) {
+                closeConnection(fd);
+                return;
+            }
+            c.peerClosed = true;
+            updateEvents(fd, c);
+            // Bez zahteva u grupi ostaju samo odgovori na neispravne linije; flush zatvara kad ih posalje
+            if (batch.size() == queued) flush(fd);
+            return;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeConnection(fd);
+            return;
+        }
+        break;
+    }
+
+    // Odgovori na neispravne linije ne cekaju primenu grupe
+    if (!c.out.empty() && !c.wantsWrite) flush(fd);
+}
+
+// Delimo na linije; nedovrsena linija ostaje za sledeci tick
+void BookingService::parseLines(int fd, Connection& c) {
+    size_t start = 0, end;
+    while ((end = c.in.find('\n', start)) != std::string::npos) {
+        std::istringstream line(c.in.substr(start, end - start));
+        start = end + 1;
+        Request r;
+        r.fd = fd;
+        r.arg = -1;
+        if (!(line >> r.id)) continue;
+
+        // Neispravan zahtev ne ide u grupu: odgovor se salje odmah, bez diranja mape
+        bool ok = (bool)(line >> r.op);
+        if (ok && (r.op == "RESERVE" || r.op == "CANCEL" || r.op == "BUY")) {
+            std::string extra;
+            ok = (line >> r.arg) && !(line >> extra);
+        }
+        if (ok) batch.push_back(r);
+        else c.out += r.id + " ERR BAD_REQUEST\n";
+    }
+    c.in.erase(0, start);
+}
+
+void BookingService::flush(int fd) {
+    Connection& c = connections[fd];
+    while (!c.out.empty()) {
+        ssize_t sent = write(fd, c.out.data(), c.out.size());
+        if (sent > 0) {
+            c.out.erase(0, sent);
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeConnection(fd);
+            return;
+        }
+        break;
+    }
+
+    // Klijent koji je zavrsio slanje se zatvara tek kad dobije sve odgovore
+    if (c.peerClosed && c.out.empty()) {
+        closeConnection(fd);
+        return;
+    }
+
+    // Ako socket ne moze da primi sve, cekamo EPOLLOUT
+    bool wantsWrite = !c.out.empty();
+    if (wantsWrite != c.wantsWrite) {
+        c.wantsWrite = wantsWrite;
+        updateEvents(fd, c);
+    }
+}
+
+void BookingService::updateEvents(int fd, const Connection& c) {
+    epoll_event ev;
+    ev.events = (c.peerClosed ? 0u : (uint32_t)EPOLLIN) | (c.wantsWrite ? (uint32_t)EPOLLOUT : 0u);
+    ev.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void BookingService::closeConnection(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+    close(fd);
+    connections.erase(fd);
+
+    // Broj fd-a moze odmah da dobije nova konekcija, zato brisemo i njene neobradjene zahteve
+    batch.erase(std::remove_if(batch.begin(), batch.end(), [fd](const Request& r) { return r.fd == fd; }), batch.end());
+}
+
+int runBookingDaemon(const std::string& socketPath, bool useJournal) {
+    SeatManager sm;
+    SeatJournal journal;
+    if (useJournal && journal.open("seats")) {
+        journal.recover(sm);
+        sm.journal = &journal;
+    }
+
+    BookingService service;
+    if (!service.start(socketPath)) return -1;
+
+    auto lastReport = std::chrono::steady_clock::now();
+    while (true) {
+        service.poll(sm, 1000, true);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport > std::chrono::seconds(5)) {
+            std::cout << "Servis: " << service.requestsServed << " zahteva u " << service.batchesApplied
+                << " grupa (najveca " << service.largestBatch << ")" << std::endl;
+            lastReport = now;
+        }
+    }
+}
+
+// Klijent koji drzi "depth" zahteva u letu po konekciji i meri vreme do odgovora
+int runBookingLoadGenerator(const std::string& socketPath, int connectionCount, int depth, int total) {
+    sockaddr_un addr;
+    if (!fillAddress(addr, socketPath)) return -1;
+
+    typedef std::chrono::steady_clock Clock;
+    struct Client {
+        int fd;
+        std::string in;
+        std::unordered_map<uint32_t, Clock::time_point> inFlight;
+    };
+
+    std::vector<Client> clients(connectionCount);
+    int ep = epoll_create1(0);
+    for (int i = 0; i < connectionCount; i++) {
+        clients[i].fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(clients[i].fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            std::cout << "GRESKA: Nema servisa na " << socketPath << ": " << strerror(errno) << std::endl;
+            return -1;
+        }
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        epoll_ctl(ep, EPOLL_CTL_ADD, clients[i].fd, &ev);
+    }
+
+    std::mt19937 rng(12345);
+    uint32_t nextId = 0;
+    int sent = 0, received = 0;
+    std::vector<double> latencies;
+    latencies.reserve(total);
+
+    // Konekcija koja je pukla vise ne dobija odgovore: njeni zahtevi se ne broje kao poslati
+    auto drop = [&](Client& c) {
+        sent -= (int)c.inFlight.size();
+        c.inFlight.clear();
+        epoll_ctl(ep, EPOLL_CTL_DEL, c.fd, NULL);
+        close(c.fd);
+        c.fd = -1;
+    };
+
+    auto send = [&](Client& c) {
+        if (c.fd < 0) return;
+        std::string msg;
+        while ((int)c.inFlight.size() < depth && sent < total) {
+            uint32_t id = nextId++;
+            int pick = rng() % 10;
+            if (pick < 5) msg += std::to_string(id) + " RESERVE " + std::to_string(rng() % 72) + "\n";
+            else if (pick < 9) msg += std::to_string(id) + " CANCEL " + std::to_string(rng() % 72) + "\n";
+            else msg += std::to_string(id) + " BUY " + std::to_string(1 + rng() % 3) + "\n";
+            c.inFlight[id] = Clock::now();
+            sent++;
+        }
+        if (!msg.empty() && write(c.fd, msg.data(), msg.size()) < 0) drop(c);
+    };
+
+    auto t0 = Clock::now();
+    for (Client& c : clients) send(c);
+
+    epoll_event events[64];
+    while (received < sent) {
+        int n = epoll_wait(ep, events, 64, 5000);
+        if (n <= 0) {
+            std::cout << "GRESKA: Servis ne odgovara." << std::endl;
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            Client& c = clients[events[i].data.u32];
+            char buf[65536];
+            ssize_t got = read(c.fd, buf, sizeof(buf));
+            if (got == 0 || (got < 0 && errno != EINTR)) {
+                drop(c);
+                continue;
+            }
+            if (got < 0) continue;
+            c.in.append(buf, got);
+
+            size_t start = 0, end;
+            Clock::time_point now = Clock::now();
+            while ((end = c.in.find('\n', start)) != std::string::npos) {
+                uint32_t id = (uint32_t)strtoul(c.in.c_str() + start, NULL, 10);
+                auto it = c.inFlight.find(id);
+                if (it != c.inFlight.end()) {
+                    latencies.push_back(std::chrono::duration<double, std::micro>(now - it->second).count());
+                    c.inFlight.erase(it);
+                    received++;
+                }
+                start = end + 1;
+            }
+            c.in.erase(0, start);
+            send(c);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    for (Client& c : clients) if (c.fd >= 0) close(c.fd);
+    close(ep);
+    if (latencies.empty()) return -1;
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Opterecenje: " << connectionCount << " konekcija x " << depth << " u letu, " << received << " zahteva" << std::endl;
+    std::cout << "  " << (uint64_t)(received / elapsed) << " zahteva/s, p50 " << latencies[latencies.size() / 2]
+        << " us, p99 " << latencies[latencies.size() * 99 / 100] << " us" << std::endl;
+    return 0;
+}
+
+#else
+
+// Na Windows-u nema epoll-a; kiosk tada radi kao ranije, samo sa lokalnim unosom
+BookingService::BookingService() {
+    listenFd = -1;
+    epollFd = -1;
+    snapshots = NULL;
+    writesOpen = NULL;
+    stopping = false;
+}
+
+BookingService::~BookingService() {}
+
+bool BookingService::start(const std::string& socketPath) {
+    std::cout << "Servis za rezervacije nije podrzan na ovoj platformi (" << socketPath << ")." << std::endl;
+    return false;
+}
+
+void BookingService::stop() {}
+
+int BookingService::poll(SeatManager&, int, bool) {
+    return 0;
+}
+
+bool BookingService::startThread(SeatManager&, SeatSnapshotStore&, std::atomic<bool>&) {
+    return false;
+}
+
+int runBookingDaemon(const std::string& socketPath, bool) {
+    std::cout << "Servis za rezervacije nije podrzan na ovoj platformi (" << socketPath << ")." << std::endl;
+    return -1;
+}
+
+int runBookingLoadGenerator(const std::string& socketPath, int, int, int) {
+    std::cout << "Generator opterecenja nije podrzan na ovoj platformi (" << socketPath << ")." << std::endl;
+    return -1;
+}
+
+#endif
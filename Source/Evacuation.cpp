@@ -0,0 +1,98 @@
+#include "../Header/Evacuation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Pravougaona sala sa seatCount sedista izmedju platna i donjih vrata; razmak izmedju sedista
+// (u oba smera) je prolaz sirok dve celije mreze
+static std::vector<Seat> gridHall(int seatCount, float& cellSize) {
+    int cols = (int)std::ceil(std::sqrt((double)seatCount));
+    int rows = (seatCount + cols - 1) / cols;
+    float sx = 1.5f / cols, sy = 1.3f / rows;
+    cellSize = std::min(sx, sy) / 4.0f;
+
+    std::vector<Seat> seats;
+    seats.reserve(seatCount);
+    for (int i = 0; i < seatCount; i++) {
+        Seat s;
+        s.x = -0.8f + (i % cols) * sx;
+        s.y = 0.45f - (i / cols + 1) * sy;
+        s.width = sx * 0.5f;
+        s.height = sy * 0.5f;
+        s.state = SOLD;
+        seats.push_back(s);
+    }
+    return seats;
+}
+
+int runEvacuation(int seatCount, int doorCount, int capacity, uint64_t seed) {
+    std::vector<Seat> seats;
+    float cellSize = 0.02f;
+    if (seatCount > 0) seats = gridHall(seatCount, cellSize);
+    else {
+        SeatManager sm;
+        seats = sm.seats;
+    }
+    std::vector<Door> doors = defaultDoorLayout(doorCount);
+
+    auto t0 = std::chrono::steady_clock::now();
+    HallNavigation nav;
+    nav.build(seats, doors, cellSize);
+    Evacuation evac;
+    evac.capacity = capacity;
+    evac.buildRoutes(nav);
+    double buildMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() * 1000.0;
+
+    CounterRng rng(seed);
+    t0 = std::chrono::steady_clock::now();
+    evac.run(seats, nav, doors, rng, 0);
+    double runMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() * 1000.0;
+
+    std::cout << "Evakuacija: " << seats.size() << " sedista, " << doors.size() << " vrata, mreza " << nav.grid.width << "x"
+        << nav.grid.height << ", " << capacity << " covek po celiji" << std::endl;
+    std::cout << "  Svi napolju za " << evac.totalTime << " s (90% za " << evac.time90 << " s), " << evac.evacuated << " ljudi";
+    if (evac.stranded) std::cout << ", " << evac.stranded << " bez puta do vrata";
+    std::cout << std::endl;
+    for (size_t i = 0; i < doors.size(); i++) {
+        const Door& d = doors[i];
+        std::cout << "  Vrata " << i + 1 << ": " << d.exited << " izaslo, poslednji u " << d.lastExit << " s";
+        if (d.exited > 0 && d.lastExit > 0.0f) std::cout << ", protok " << d.exited / d.lastExit << " ljudi/s";
+        std::cout << std::endl;
+    }
+
+    // Uska grla: mesta gde red pocinje. Red ceka skoro jednako u svakoj svojoj celiji, pa se celija
+    // ocenjuje po tome koliko se u njoj cekalo vise nego u celiji ispred nje (na vratima: ukupno cekanje).
+    // Od bliskih celija (do 3 celije udaljenosti) prikazuje se samo najgora.
+    std::vector<int> cells;
+    std::vector<float> score(evac.cellWait.size(), 0.0f);
+    for (int c = 0; c < (int)evac.cellWait.size(); c++) {
+        if (evac.cellWait[c] <= 0.0f) continue;
+        int next = evac.nextOf(c);
+        score[c] = evac.cellWait[c] - (next >= 0 ? evac.cellWait[next] : 0.0f);
+        if (score[c] > 0.0f) cells.push_back(c);
+    }
+    std::sort(cells.begin(), cells.end(), [&](int a, int b) { return score[a] > score[b]; });
+    std::vector<int> shown;
+    int w = nav.grid.width;
+    for (size_t i = 0; i < cells.size() && shown.size() < 5; i++) {
+        bool near = false;
+        for (int c : shown) {
+            near = near || (std::abs(c % w - cells[i] % w) <= 3 && std::abs(c / w - cells[i] / w) <= 3);
+        }
+        if (!near) shown.push_back(cells[i]);
+    }
+    std::cout << "  Uska grla:" << std::endl;
+    for (int c : shown) {
+        float x, y;
+        nav.grid.cellCenter(c, x, y);
+        std::cout << "    (" << x << ", " << y << "): " << score[c] << " covek-s vise nego ispred (ukupno " << evac.cellWait[c] << ")" << std::endl;
+    }
+
+    std::cout << "  Priprema (polja toka) " << buildMs << " ms, simulacija " << runMs << " ms (" << evac.ticks << " koraka, "
+        << evac.agentSteps << " koraka agenata)" << std::endl;
+    return evac.evacuated + evac.stranded == (int)seats.size() ? 0 : 1;
+}
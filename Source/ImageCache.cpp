@@ -0,0 +1,253 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/ImageCache.h"
+#include "../Header/AssetPack.h"
+#include "../Header/stb_image.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static const uint32_t IMAGE_CACHE_MAGIC = 0x31434953; // "SIC1"
+
+// Zaglavlje zapisa u kesu; posle njega width * height * pixelChannels bajtova
+struct ImageCacheHeader {
+    uint32_t magic;
+    uint32_t width, height;
+    uint32_t fileChannels;   // kanali u slici (kao *channels iz stbi_load)
+    uint32_t pixelChannels;  // kanali u zapisu (desiredChannels ili fileChannels)
+    uint32_t flipped;
+    uint64_t contentHash;
+    uint32_t decodeMicros;   // koliko je trajalo dekodiranje (za procenu ustede)
+    uint32_t reserved;
+};
+
+// Poslednje vidjeno stanje slike: dok su velicina i vreme izmene isti, hes sadrzaja vazi
+struct ImageIndexEntry {
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+};
+
+namespace {
+    std::mutex cacheMutex; // atlas dekodira na vise niti
+    std::string cacheDirectory = "image_cache";
+    bool indexLoaded = false;
+    std::unordered_map<std::string, ImageIndexEntry> imageIndex;
+    ImageCacheStats stats;
+
+    double secondsNow() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // FNV-1a preko bajtova
+    uint64_t hashBytes(const unsigned char* p, size_t size) {
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < size; i++) {
+            h ^= p[i];
+            h *= 0x100000001B3ull;
+        }
+        return h;
+    }
+
+    bool readFile(const std::string& path, std::vector<unsigned char>& out) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == NULL) return false;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        out.resize(size > 0 ? (size_t)size : 0);
+        bool ok = size > 0 && fread(out.data(), 1, out.size(), file) == out.size();
+        fclose(file);
+        return ok;
+    }
+
+    std::string indexPath() {
+        return cacheDirectory + "/index.txt";
+    }
+
+    // Red indeksa: velicina, vreme izmene, hes (hex), putanja do kraja reda
+    void loadIndex() {
+        indexLoaded = true;
+        FILE* file = fopen(indexPath().c_str(), "r");
+        if (file == NULL) return;
+        unsigned long long size, hash;
+        long long mtime;
+        char path[1024];
+        while (fscanf(file, "%llu %lld %llx %1023[^\n]", &size, &mtime, &hash, path) == 4) {
+            imageIndex[path] = ImageIndexEntry{ (uint64_t)size, (int64_t)mtime, (uint64_t)hash };
+        }
+        fclose(file);
+    }
+
+    void makeDirectory(const std::string& directory) {
+#ifdef _WIN32
+        _mkdir(directory.c_str());
+#else
+        mkdir(directory.c_str(), 0755);
+#endif
+    }
+
+    void saveIndex() {
+        makeDirectory(cacheDirectory);
+        FILE* file = fopen(indexPath().c_str(), "w");
+        if (file == NULL) return;
+        for (const auto& e : imageIndex) {
+            fprintf(file, "%llu %lld %016llx %s\n", (unsigned long long)e.second.size, (long long)e.second.mtime,
+                (unsigned long long)e.second.hash, e.first.c_str());
+        }
+        fclose(file);
+    }
+
+    std::string entryPath(uint64_t hash, int desiredChannels, bool flip) {
+        char name[64];
+        snprintf(name, sizeof(name), "/%016llx_%d%s.img", (unsigned long long)hash, desiredChannels, flip ? "f" : "");
+        return cacheDirectory + name;
+    }
+
+    void flipRows(unsigned char* pixels, int width, int height, int channels) {
+        size_t stride = (size_t)width * channels;
+        std::vector<unsigned char> row(stride);
+        for (int y = 0; y < height / 2; y++) {
+            unsigned char* a = pixels + y * stride;
+            unsigned char* b = pixels + (height - 1 - y) * stride;
+            memcpy(row.data(), a, stride);
+            memcpy(a, b, stride);
+            memcpy(b, row.data(), stride);
+        }
+    }
+
+    // Gotovi pikseli iz kesa (malloc, kao stbi_load); NULL ako zapisa nema ili nije ispravan
+    unsigned char* readEntry(const std::string& path, uint64_t hash, int desiredChannels, bool flip,
+        int* width, int* height, int* channels, uint32_t* decodeMicros) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == NULL) return NULL;
+        ImageCacheHeader header;
+        unsigned char* pixels = NULL;
+        if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == IMAGE_CACHE_MAGIC && header.contentHash == hash
+            && header.flipped == (flip ? 1u : 0u) && (desiredChannels == 0 || (int)header.pixelChannels == desiredChannels)) {
+            size_t bytes = (size_t)header.width * header.height * header.pixelChannels;
+            pixels = (unsigned char*)malloc(bytes);
+            if (pixels != NULL && fread(pixels, 1, bytes, file) != bytes) {
+                free(pixels);
+                pixels = NULL;
+            }
+            *width = header.width;
+            *height = header.height;
+            *channels = header.fileChannels;
+            *decodeMicros = header.decodeMicros;
+        }
+        fclose(file);
+        return pixels;
+    }
+
+    // Zapis ide u privremeni fajl pa se preimenuje: druga nit ili proces nikad ne cita pola zapisa
+    void writeEntry(const std::string& path, const ImageCacheHeader& header, const unsigned char* pixels) {
+        std::string tmpPath = path + ".tmp";
+        FILE* file = fopen(tmpPath.c_str(), "wb");
+        if (file == NULL) return;
+        size_t bytes = (size_t)header.width * header.height * header.pixelChannels;
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(pixels, 1, bytes, file) == bytes;
+        ok = fclose(file) == 0 && ok;
+        remove(path.c_str());
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) remove(tmpPath.c_str());
+    }
+}
+
+void imageCacheSetDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheDirectory = directory;
+    imageIndex.clear();
+    indexLoaded = false;
+}
+
+ImageCacheStats imageCacheStats() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return stats;
+}
+
+unsigned char* loadImageCached(const char* filePath, int* width, int* height, int* channels, int desiredChannels, bool flip) {
+    double t0 = secondsNow();
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        directory = cacheDirectory;
+    }
+    if (directory.empty()) {
+        unsigned char* pixels = stbi_load(filePath, width, height, channels, desiredChannels);
+        if (pixels != NULL && flip) flipRows(pixels, *width, *height, desiredChannels ? desiredChannels : *channels);
+        return pixels;
+    }
+
+    // Hes sadrzaja: iz indeksa ako se slika nije menjala, inace se slika cita i hesira
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!fileStamp(filePath, size, mtime)) return NULL;
+    uint64_t hash = 0;
+    bool known = false;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (!indexLoaded) loadIndex();
+        auto it = imageIndex.find(filePath);
+        if (it != imageIndex.end() && it->second.size == size && it->second.mtime == mtime) {
+            hash = it->second.hash;
+            known = true;
+        }
+    }
+    std::vector<unsigned char> source;
+    if (!known) {
+        if (!readFile(filePath, source)) return NULL;
+        hash = hashBytes(source.data(), source.size());
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        imageIndex[filePath] = ImageIndexEntry{ size, mtime, hash };
+        saveIndex();
+    }
+
+    std::string path = entryPath(hash, desiredChannels, flip);
+    uint32_t decodeMicros = 0;
+    unsigned char* pixels = readEntry(path, hash, desiredChannels, flip, width, height, channels, &decodeMicros);
+    if (pixels != NULL) {
+        double elapsed = secondsNow() - t0;
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        stats.hits++;
+        stats.hitTime += elapsed;
+        stats.savedTime += decodeMicros / 1e6 - elapsed;
+        return pixels;
+    }
+
+    // Promasaj: dekodira se (iz vec procitanih bajtova ako ih ima) i zapisuje u kes
+    double decodeStart = secondsNow();
+    if (source.empty() && !readFile(filePath, source)) return NULL;
+    pixels = stbi_load_from_memory(source.data(), (int)source.size(), width, height, channels, desiredChannels);
+    if (pixels == NULL) return NULL;
+    int pixelChannels = desiredChannels ? desiredChannels : *channels;
+    if (flip) flipRows(pixels, *width, *height, pixelChannels);
+    double decodeTime = secondsNow() - decodeStart;
+
+    ImageCacheHeader header = {};
+    header.magic = IMAGE_CACHE_MAGIC;
+    header.width = *width;
+    header.height = *height;
+    header.fileChannels = *channels;
+    header.pixelChannels = pixelChannels;
+    header.flipped = flip ? 1 : 0;
+    header.contentHash = hash;
+    header.decodeMicros = (uint32_t)(decodeTime * 1e6);
+    makeDirectory(directory);
+    writeEntry(path, header, pixels);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    stats.misses++;
+    stats.decodeTime += decodeTime;
+    return pixels;
+}
@@ -0,0 +1,311 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/InputRecorder.h"
+#include "../Header/SeatManager.h"
+#include "../Header/PersonManager.h"
+#include "../Header/CinemaSimulator.h"
+#include "../Header/FlowField.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static const uint32_t REPLAY_MAGIC = 0x31505242; // "BRP1"
+static const uint32_t REPLAY_VERSION = 3; // 2: raspored dolazaka u zaglavlju, 3: nivo detalja i njegov fokus
+
+enum ReplayRecord {
+    RECORD_FRAME = 0,
+    RECORD_CLICK = INPUT_CLICK,
+    RECORD_BUY = INPUT_BUY,
+    RECORD_START = INPUT_START,
+    RECORD_END = 0xFF
+};
+
+InputRecorder::InputRecorder() {
+    file = NULL;
+}
+
+InputRecorder::~InputRecorder() {
+    if (file) fclose(file); // bez END zapisa: reprodukcija radi, ali bez provere hesa
+}
+
+bool InputRecorder::open(const std::string& path, const ReplayConfig& config) {
+    file = fopen(path.c_str(), "wb");
+    if (file == NULL) {
+        std::cout << "GRESKA: Snimak nije moguce napraviti: " << path << std::endl;
+        return false;
+    }
+    uint8_t flags = (config.flowField ? 1 : 0) | (config.compact ? 2 : 0) | (config.lod ? 4 : 0);
+    uint8_t doors = (uint8_t)config.doorCount;
+    uint16_t reserved = 0;
+    uint32_t seatCount = (uint32_t)config.initialSeats.size();
+    fwrite(&REPLAY_MAGIC, 4, 1, file);
+    fwrite(&REPLAY_VERSION, 4, 1, file);
+    fwrite(&config.seed, 8, 1, file);
+    fwrite(&doors, 1, 1, file);
+    fwrite(&flags, 1, 1, file);
+    fwrite(&reserved, 2, 1, file);
+    fwrite(&seatCount, 4, 1, file);
+    if (seatCount) fwrite(config.initialSeats.data(), 1, seatCount, file);
+
+    uint8_t mode = (uint8_t)config.arrivals.mode;
+    uint32_t bins = (uint32_t)config.arrivals.histogram.size();
+    fwrite(&mode, 1, 1, file);
+    fwrite(&config.arrivals.window, 4, 1, file);
+    fwrite(&bins, 4, 1, file);
+    if (bins) fwrite(config.arrivals.histogram.data(), 4, bins, file);
+
+    float focus[4] = { config.focus.x0, config.focus.y0, config.focus.x1, config.focus.y1 };
+    fwrite(focus, 4, 4, file);
+    frames = 0;
+    std::cout << "Snimanje ulaza u " << path << std::endl;
+    return true;
+}
+
+void InputRecorder::frame(float dt, const std::vector<InputEvent>& events) {
+    if (file == NULL) return;
+    uint8_t type = RECORD_FRAME;
+    fwrite(&type, 1, 1, file);
+    fwrite(&dt, 4, 1, file);
+    for (const InputEvent& e : events) {
+        fwrite(&e.type, 1, 1, file);
+        if (e.type == INPUT_CLICK) {
+            fwrite(&e.x, 4, 1, file);
+            fwrite(&e.y, 4, 1, file);
+        }
+        else if (e.type == INPUT_BUY) fwrite(&e.count, 1, 1, file);
+    }
+    frames++;
+}
+
+void InputRecorder::close(uint64_t finalHash) {
+    if (file == NULL) return;
+    uint8_t type = RECORD_END;
+    fwrite(&type, 1, 1, file);
+    fwrite(&finalHash, 8, 1, file);
+    fwrite(&frames, 4, 1, file);
+    fclose(file);
+    file = NULL;
+    std::cout << "Snimak zatvoren: " << frames << " frejmova" << std::endl;
+}
+
+InputReplay::InputReplay() {
+    file = NULL;
+    pending = false;
+}
+
+InputReplay::~InputReplay() {
+    close();
+}
+
+bool InputReplay::open(const std::string& path) {
+    file = fopen(path.c_str(), "rb");
+    if (file == NULL) {
+        std::cout << "GRESKA: Snimak ne postoji: " << path << std::endl;
+        return false;
+    }
+    uint32_t magic = 0, version = 0, seatCount = 0;
+    uint8_t doors = 0, flags = 0;
+    uint16_t reserved = 0;
+    bool ok = fread(&magic, 4, 1, file) == 1 && fread(&version, 4, 1, file) == 1
+        && fread(&config.seed, 8, 1, file) == 1 && fread(&doors, 1, 1, file) == 1
+        && fread(&flags, 1, 1, file) == 1 && fread(&reserved, 2, 1, file) == 1
+        && fread(&seatCount, 4, 1, file) == 1;
+    if (!ok || magic != REPLAY_MAGIC || version < 1 || version > REPLAY_VERSION) {
+        std::cout << "GRESKA: Neispravan snimak: " << path << std::endl;
+        close();
+        return false;
+    }
+    config.doorCount = doors;
+    config.flowField = (flags & 1) != 0;
+    config.compact = (flags & 2) != 0;
+    config.lod = (flags & 4) != 0;
+    config.initialSeats.resize(seatCount);
+    if (seatCount && fread(config.initialSeats.data(), 1, seatCount, file) != seatCount) {
+        std::cout << "GRESKA: Snimak je skracen: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    config.arrivals = ArrivalSchedule();
+    if (version >= 2) {
+        uint8_t mode = 0;
+        uint32_t bins = 0;
+        ok = fread(&mode, 1, 1, file) == 1 && fread(&config.arrivals.window, 4, 1, file) == 1
+            && fread(&bins, 4, 1, file) == 1 && mode <= ARRIVE_HISTOGRAM;
+        if (ok) {
+            config.arrivals.mode = (ArrivalMode)mode;
+            config.arrivals.histogram.resize(bins);
+            ok = bins == 0 || fread(config.arrivals.histogram.data(), 4, bins, file) == bins;
+        }
+        if (!ok) {
+            std::cout << "GRESKA: Snimak je skracen: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    config.focus = FocusRect();
+    if (version >= 3) {
+        float focus[4];
+        if (fread(focus, 4, 4, file) != 4) {
+            std::cout << "GRESKA: Snimak je skracen: " << path << std::endl;
+            close();
+            return false;
+        }
+        config.focus.x0 = focus[0];
+        config.focus.y0 = focus[1];
+        config.focus.x1 = focus[2];
+        config.focus.y1 = focus[3];
+    }
+    frames = 0;
+    pending = false;
+    hasFinalHash = false;
+    return true;
+}
+
+void InputReplay::close() {
+    if (file) fclose(file);
+    file = NULL;
+}
+
+bool InputReplay::nextFrame(float& dt, std::vector<InputEvent>& events) {
+    events.clear();
+    if (file == NULL) return false;
+
+    uint8_t type;
+    if (!pending) {
+        if (fread(&type, 1, 1, file) != 1) return false;
+        if (type == RECORD_END) {
+            uint32_t recorded = 0;
+            hasFinalHash = fread(&finalHash, 8, 1, file) == 1 && fread(&recorded, 4, 1, file) == 1;
+            return false;
+        }
+        if (type != RECORD_FRAME) return false;
+    }
+    pending = false;
+    if (fread(&dt, 4, 1, file) != 1) return false;
+
+    // Dogadjaji ovog frejma, do sledeceg FRAME/END zapisa
+    while (fread(&type, 1, 1, file) == 1) {
+        if (type == RECORD_FRAME) {
+            pending = true;
+            break;
+        }
+        if (type == RECORD_END) {
+            uint32_t recorded = 0;
+            hasFinalHash = fread(&finalHash, 8, 1, file) == 1 && fread(&recorded, 4, 1, file) == 1;
+            break;
+        }
+        InputEvent e;
+        e.type = type;
+        e.count = 0;
+        e.x = e.y = 0.0f;
+        bool ok = true;
+        if (type == RECORD_CLICK) ok = fread(&e.x, 4, 1, file) == 1 && fread(&e.y, 4, 1, file) == 1;
+        else if (type == RECORD_BUY) ok = fread(&e.count, 1, 1, file) == 1;
+        else if (type != RECORD_START) ok = false;
+        if (!ok) break;
+        events.push_back(e);
+    }
+    frames++;
+    return true;
+}
+
+// FNV-1a preko bajtova
+static void hashBytes(uint64_t& h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+}
+
+uint64_t simulationHash(const SeatManager& sm, const PersonManager& pm, const CinemaSimulator& sim) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const Seat& s : sm.seats) {
+        uint8_t state = (uint8_t)s.state;
+        hashBytes(h, &state, 1);
+    }
+    for (const Person& p : pm.people) {
+        hashBytes(h, &p.x, sizeof(float));
+        hashBytes(h, &p.y, sizeof(float));
+        uint8_t flags = (p.reachedRow ? 1 : 0) | (p.seated ? 2 : 0) | (p.isExiting ? 4 : 0) | (p.hasLeft ? 8 : 0);
+        hashBytes(h, &flags, 1);
+    }
+    for (const CompactPerson& c : pm.compactPeople) {
+        hashBytes(h, &c.x, sizeof(c.x));
+        hashBytes(h, &c.y, sizeof(c.y));
+        hashBytes(h, &c.flags, 1);
+    }
+    for (const LodAgent& a : pm.lodAgents) {
+        hashBytes(h, &a.seat, sizeof(a.seat));
+        hashBytes(h, &a.door, 1);
+        hashBytes(h, &a.phase, 1);
+        hashBytes(h, &a.t0, sizeof(float));
+        hashBytes(h, &a.s0, sizeof(float));
+    }
+    int state = (int)sim.currentState;
+    hashBytes(h, &state, sizeof(state));
+    hashBytes(h, &sim.movieTimer, sizeof(float));
+    hashBytes(h, &sim.screenR, sizeof(float));
+    hashBytes(h, &sim.screenG, sizeof(float));
+    hashBytes(h, &sim.screenB, sizeof(float));
+    return h;
+}
+
+int runHeadlessReplay(const std::string& path) {
+    InputReplay replay;
+    if (!replay.open(path)) return -1;
+
+    SeatManager seatManager;
+    if (replay.config.initialSeats.size() != seatManager.seats.size()) {
+        std::cout << "GRESKA: Snimak je napravljen za salu sa " << replay.config.initialSeats.size() << " sedista" << std::endl;
+        return -1;
+    }
+    for (size_t i = 0; i < seatManager.seats.size(); i++) seatManager.seats[i].state = (SeatState)replay.config.initialSeats[i];
+
+    PersonManager personManager(false);
+    CinemaSimulator simulator(false);
+    personManager.doors = defaultDoorLayout(replay.config.doorCount);
+    personManager.compact = replay.config.compact;
+    personManager.arrivals = replay.config.arrivals;
+    personManager.lod = replay.config.lod && !replay.config.flowField;
+    personManager.focus = replay.config.focus;
+    personManager.rng.setSeed(replay.config.seed);
+    simulator.rng.setSeed(replay.config.seed);
+    HallNavigation hallNav;
+    if (replay.config.flowField) {
+        hallNav.build(seatManager.seats, personManager.doors);
+        personManager.nav = &hallNav;
+    }
+
+    // Isti redosled kao glavna petlja: ulaz, korak simulacije, pa pocetak projekcije
+    float dt;
+    std::vector<InputEvent> events;
+    double simulated = 0.0;
+    auto t0 = std::chrono::steady_clock::now();
+    while (replay.nextFrame(dt, events)) {
+        bool startRequested = false;
+        for (const InputEvent& e : events) {
+            if (seatManager.applyInput(e)) startRequested = true;
+        }
+        simulator.update(dt, personManager, seatManager);
+        if (startRequested) simulator.startProjection(personManager, seatManager.seats);
+        simulated += dt;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t hash = simulationHash(seatManager, personManager, simulator);
+    std::cout << "Reprodukcija: " << replay.frames << " frejmova (" << simulated << " s simulacije) za " << elapsed
+        << " s, " << replay.frames / (elapsed > 0.0 ? elapsed : 1e-9) << " frejmova/s" << std::endl;
+    if (!replay.hasFinalHash) {
+        std::cout << "UPOZORENJE: Snimak nije uredno zatvoren, krajnje stanje se ne moze proveriti." << std::endl;
+        return 0;
+    }
+    if (hash != replay.finalHash) {
+        std::cout << "GRESKA: Krajnje stanje se razlikuje od snimljenog!" << std::endl;
+        return 1;
+    }
+    std::cout << "Krajnje stanje se poklapa sa snimljenim." << std::endl;
+    return 0;
+}
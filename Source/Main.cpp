@@ -1,20 +1,196 @@
 ﻿#include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <ctime>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
 
 #include "../Header/Util.h"
 #include "../Header/SeatManager.h"
 #include "../Header/PersonManager.h"
 #include "../Header/CinemaSimulator.h" 
+#include "../Header/SeatJournal.h"
+#include "../Header/SeatEventStream.h"
+#include "../Header/SeatRenderer.h"
+#include "../Header/Benchmarks.h"
+#include "../Header/BookingService.h"
+#include "../Header/SeatSharedMap.h"
+#include "../Header/SeatSnapshot.h"
+#include "../Header/InputRecorder.h"
+#include "../Header/MonteCarlo.h"
+#include "../Header/Evacuation.h"
+#include "../Header/TextureAtlas.h"
+#include "../Header/SpriteBatch.h"
+#include "../Header/GlStateCache.h"
+#include "../Header/RetainedFrame.h"
+#include "../Header/ImageCache.h"
+#include "../Header/ShaderWatcher.h"
 
 const double TARGET_FPS = 75.0;
 const double TARGET_FRAME_TIME = 1.0 / TARGET_FPS;
+const char* DEFAULT_BOOKING_SOCKET = "/tmp/bioskop.sock";
+const char* DEFAULT_SHARED_MAP = "/bioskop_seats";
+const char* DEFAULT_RECORDING = "session.rec";
+const char* DEFAULT_ASSET_PACK = "assets.pack";
+
+// Rezim na zahtev: koliko najduze petlja spava u IDLE i koliko cesto se proverava ono sto
+// ne javlja promene samo (servis u glavnoj petlji, deljena mapa displeja)
+const double ON_DEMAND_MAX_SLEEP = 1.0;
+const double ON_DEMAND_POLL_INTERVAL = 0.05;
+
+// Prozor treba ponovo nacrtati (otkriven, promenjena velicina) iako se scena nije menjala
+static bool windowDamaged = true;
+
+static void onWindowRefresh(GLFWwindow*) {
+    windowDamaged = true;
+}
+
+int main(int argc, char** argv) {
+    bool useJournal = true;
+    std::string bookingSocket;
+    bool bookingThread = false; // servis za rezervacije na svojoj niti umesto u glavnoj petlji
+    bool useFlowField = false;  // ljudi idu prolazima oko sedista (polje toka) umesto pravih linija
+    int doorCount = 1;          // vece sale imaju 2-6 vrata
+    bool compactPeople = false; // sazet zapis ljudi (za ogromne sale)
+    uint64_t seed = (uint64_t)time(0); // --seed N za ponovljiv rad
+    std::string sharedMapName;  // kiosk deli svoju mapu sedista drugim procesima
+    std::string viewerMapName;  // displej: samo prikazuje mapu sedista iz deljene memorije
+    std::string recordPath;     // snimanje ulaza (za reprodukciju greske ili kao merni scenario)
+    std::string replayPath;     // reprodukcija snimka umesto zivog ulaza
+    bool headless = false;      // reprodukcija bez prozora
+    double replaySpeed = 1.0;   // 0 = najbrze moguce
+    bool monteCarlo = false;    // statisticka procena vremena punjenja/praznjenja umesto prozora
+    MonteCarloConfig mcConfig;
+    ArrivalSchedule arrivals;   // --arrivals poisson|fajl: postepen dolazak umesto svih odjednom
+    int evacuateSeats = -1;     // evakuacija bez prozora: 0 = originalna sala, N = pravougaona sala sa N sedista
+    int evacCapacity = 1;       // ljudi po celiji mreze pri evakuaciji
+    std::string servePath;      // servis za rezervacije bez prozora (--serve [putanja])
+    bool renderStats = false;   // povremeno ispisuje koliko se crta po frejmu
+    bool onDemand = false;      // u IDLE se crta samo kada se nesto promeni, a petlja izmedju toga spava
+    bool dirtyRects = false;    // ponovo se crtaju samo promenjeni delovi ekrana (ostalo ostaje u framebuffer-u)
+    bool syncTextures = false;  // slike se ucitavaju pre prvog frejma (inace stizu sa radnih niti)
+    std::string assetPack = DEFAULT_ASSET_PACK; // unapred pripremljen atlas (--pack-assets); prazno = uvek PNG
+    bool shaderDev = false;     // sejderi iz fajlova (ne ugradjeni) i ponovo se ucitavaju cim se izmene
+    std::vector<std::string> spriteFiles = { "person.png", "open.png", "close.png", "potpis.png" };
+    bool lod = false;           // pojedinacno samo ljudi u fokusu, ostali kao gustina (za ogromne sale)
+    FocusRect lodFocus;
+    lodFocus.x0 = lodFocus.y0 = -0.5f;
+    lodFocus.x1 = lodFocus.y1 = 0.5f;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        // Opcioni argument (npr. putanja socket-a) ako sledeci ne pocinje sa "--"
+        std::string next = (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0) ? argv[i + 1] : "";
+
+        if (arg == "--bench-journal") return runJournalBenchmark();
+        else if (arg == "--bench-events") return runEventStreamBenchmark();
+        else if (arg == "--bench-flowfield") return runFlowFieldBenchmark();
+        else if (arg == "--bench-doors") return runDoorBenchmark();
+        else if (arg == "--bench-pool") return runPersonPoolBenchmark();
+        else if (arg == "--bench-compact") return runCompactPersonBenchmark();
+        else if (arg == "--bench-lod") return runLodBenchmark();
+        else if (arg == "--no-journal") useJournal = false;
+        else if (arg == "--listen") bookingSocket = next.empty() ? DEFAULT_BOOKING_SOCKET : argv[++i];
+        else if (arg == "--booking-thread") bookingThread = true;
+        else if (arg == "--flowfield") useFlowField = true;
+        else if (arg == "--compact") compactPeople = true;
+        else if (arg == "--lod") lod = true;
+        else if (arg == "--render-stats") renderStats = true;
+        else if (arg == "--on-demand") onDemand = true;
+        else if (arg == "--dirty-rects") dirtyRects = true;
+        else if (arg == "--sync-textures") syncTextures = true;
+        else if (arg == "--pack-assets") {
+            TextureAtlas packer;
+            return packer.writePack(next.empty() ? DEFAULT_ASSET_PACK : argv[++i], spriteFiles) ? 0 : -1;
+        }
+        else if (arg == "--asset-pack" && !next.empty()) assetPack = argv[++i];
+        else if (arg == "--no-pack") assetPack.clear();
+        else if (arg == "--image-cache" && !next.empty()) imageCacheSetDirectory(argv[++i]);
+        else if (arg == "--no-image-cache") imageCacheSetDirectory("");
+        else if (arg == "--shader-dev") shaderDev = true;
+        else if (arg == "--shader-cache" && !next.empty()) setShaderCacheDirectory(argv[++i]);
+        else if (arg == "--no-shader-cache") setShaderCacheDirectory("");
+        else if (arg == "--lod-focus" && i + 4 < argc) {
+            lod = true;
+            lodFocus.x0 = (float)atof(argv[++i]);
+            lodFocus.y0 = (float)atof(argv[++i]);
+            lodFocus.x1 = (float)atof(argv[++i]);
+            lodFocus.y1 = (float)atof(argv[++i]);
+        }
+        else if (arg == "--seed" && !next.empty()) seed = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--doors" && !next.empty()) doorCount = atoi(argv[++i]);
+        else if (arg == "--share") sharedMapName = next.empty() ? DEFAULT_SHARED_MAP : argv[++i];
+        else if (arg == "--viewer") viewerMapName = next.empty() ? DEFAULT_SHARED_MAP : argv[++i];
+        else if (arg == "--record") recordPath = next.empty() ? DEFAULT_RECORDING : argv[++i];
+        else if (arg == "--replay") replayPath = next.empty() ? DEFAULT_RECORDING : argv[++i];
+        else if (arg == "--headless") headless = true;
+        else if (arg == "--replay-speed" && !next.empty()) replaySpeed = atof(argv[++i]);
+        else if (arg == "--montecarlo") {
+            monteCarlo = true;
+            if (!next.empty()) mcConfig.occupancy = atof(argv[++i]);
+        }
+        else if (arg == "--mc-turnout" && !next.empty()) mcConfig.minTurnout = (float)atof(argv[++i]);
+        else if (arg == "--mc-precision" && !next.empty()) mcConfig.precision = atof(argv[++i]);
+        else if (arg == "--mc-max" && !next.empty()) mcConfig.maxCycles = atoi(argv[++i]);
+        else if (arg == "--threads" && !next.empty()) mcConfig.threads = atoi(argv[++i]);
+        else if (arg == "--arrivals" && !next.empty()) {
+            std::string source = argv[++i];
+            if (source == "poisson") arrivals.mode = ARRIVE_POISSON;
+            else if (!arrivals.loadHistogram(source)) return -1;
+        }
+        else if (arg == "--arrival-window" && !next.empty()) arrivals.window = (float)atof(argv[++i]);
+        else if (arg == "--evacuate") evacuateSeats = next.empty() ? 0 : atoi(argv[++i]);
+        else if (arg == "--evac-capacity" && !next.empty()) evacCapacity = atoi(argv[++i]);
+        else if (arg == "--serve") servePath = next.empty() ? DEFAULT_BOOKING_SOCKET : argv[++i];
+        else if (arg == "--loadgen") {
+            // --loadgen [putanja] [konekcije] [u letu] [ukupno]
+            const char* path = i + 1 < argc ? argv[i + 1] : DEFAULT_BOOKING_SOCKET;
+            int conns = i + 2 < argc ? atoi(argv[i + 2]) : 4;
+            int depth = i + 3 < argc ? atoi(argv[i + 3]) : 16;
+            int total = i + 4 < argc ? atoi(argv[i + 4]) : 200000;
+            return runBookingLoadGenerator(path, conns, depth, total);
+        }
+    }
+
+    if (!servePath.empty()) return runBookingDaemon(servePath, useJournal);
+    if (evacuateSeats >= 0) return runEvacuation(evacuateSeats, doorCount, evacCapacity, seed);
+    if (monteCarlo) {
+        mcConfig.doorCount = doorCount;
+        mcConfig.flowField = useFlowField;
+        mcConfig.compact = compactPeople;
+        mcConfig.arrivals = arrivals;
+        mcConfig.seed = seed;
+        std::cout << "Seme: " << seed << " (ponoviti sa --seed " << seed << ")" << std::endl;
+        return runMonteCarlo(mcConfig);
+    }
 
-int main() {
-    srand(static_cast<unsigned int>(time(0)));
+    // Snimak nosi svoje seme i podesavanja; spoljni izvori promena se ne snimaju, pa su iskljuceni
+    InputReplay replay;
+    if (!replayPath.empty()) {
+        if (headless) return runHeadlessReplay(replayPath);
+        if (!replay.open(replayPath)) return -1;
+        seed = replay.config.seed;
+        doorCount = replay.config.doorCount;
+        useFlowField = replay.config.flowField;
+        compactPeople = replay.config.compact;
+        arrivals = replay.config.arrivals;
+        lod = replay.config.lod;
+        lodFocus = replay.config.focus;
+        recordPath.clear();
+    }
+    if (!replayPath.empty() || !recordPath.empty()) {
+        if (!bookingSocket.empty() || !viewerMapName.empty()) {
+            std::cout << "UPOZORENJE: Servis za rezervacije i displej se ne snimaju - iskljuceni su." << std::endl;
+        }
+        bookingSocket.clear();
+        viewerMapName.clear();
+    }
+    if (!replayPath.empty()) useJournal = false;
+
+    std::cout << "Seme: " << seed << " (ponoviti sa --seed " << seed << ")" << std::endl;
 
     if (!glfwInit()) return endProgram("GLFW greska.");
 
@@ -45,7 +221,9 @@ int main() {
     // Pozadina: #FFA878
     glClearColor(1.0f, 0.659f, 0.471f, 1.0f);
 
-    unsigned int shaderProgram = createShader("basic.vert", "basic.frag");
+    // Sejderi su ugradjeni u program (EmbeddedShaders.h); u razvojnom rezimu se citaju iz fajlova
+    unsigned int shaderProgram = shaderDev ? createShaderFromFiles("basic.vert", "basic.frag") : createShader("basic.vert", "basic.frag");
+    if (shaderProgram == 0) return endProgram("Sejder greska.");
     glUseProgram(shaderProgram);
 
     // Kvadrat
@@ -70,26 +248,205 @@ int main() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    unsigned int texturePotpis = loadImageToTexture("potpis.png");
-
-    int uPosLoc = glGetUniformLocation(shaderProgram, "uPos");
-    int uSizeLoc = glGetUniformLocation(shaderProgram, "uSize");
-    int uColorLoc = glGetUniformLocation(shaderProgram, "uColor");
-    int uUseTextureLoc = glGetUniformLocation(shaderProgram, "uUseTexture");
-    int uTexLoc = glGetUniformLocation(shaderProgram, "uTex");
-    glUniform1i(uTexLoc, 0);
+    // Sve slike sprajtova u jednoj teksturi: iz paketa ako postoji i nije zastareo, inace ih
+    // dekodiraju radne niti, a do tada se crta zamenska boja
+    TextureAtlas atlas;
+    if (onDemand) atlas.onDecoded = []() { glfwPostEmptyEvent(); };
+    bool fromPack = !assetPack.empty() && atlas.loadPack(assetPack, spriteFiles);
+    if (!fromPack && syncTextures) atlas.build(spriteFiles);
+    else if (!fromPack) atlas.start(spriteFiles);
+    Sprite spritePotpis = atlas.sprite("potpis.png");
+
+    // Lokacije i pocetne vrednosti uniformi (i posle ponovnog ucitavanja sejdera)
+    int uInstancedLoc = -1;
+    auto setupProgram = [&]() {
+        glUseProgram(shaderProgram);
+        uInstancedLoc = glGetUniformLocation(shaderProgram, "uInstanced");
+        glUniform1i(glGetUniformLocation(shaderProgram, "uTex"), 0);
+        glUniform1i(uInstancedLoc, 0);
+        glUniform4f(glGetUniformLocation(shaderProgram, "uUvRect"), 0.0f, 0.0f, 1.0f, 1.0f);
+    };
+    setupProgram();
+    ShaderWatcher shaderWatcher;
+    if (shaderDev) shaderWatcher.watch({ "basic.vert", "basic.frag" });
 
     SeatManager seatManager;
-    PersonManager personManager;
-    CinemaSimulator simulator;
+    PersonManager personManager(false);
+    CinemaSimulator simulator(false);
+    personManager.personSprite = atlas.sprite("person.png");
+    simulator.doorOpen = atlas.sprite("open.png");
+    simulator.doorClose = atlas.sprite("close.png");
+    personManager.doors = defaultDoorLayout(doorCount);
+    personManager.compact = compactPeople;
+    personManager.arrivals = arrivals;
+    personManager.rng.setSeed(seed);
+    simulator.rng.setSeed(seed);
+
+    // Displej ne pise nista svoje - sedista (i njihov raspored) uzima iz deljene memorije kioska
+    SeatSharedMapReader viewerMap;
+    std::vector<Seat> viewerSeats;
+    if (!viewerMapName.empty()) {
+        if (!viewerMap.open(viewerMapName)) return endProgram("Deljena mapa sedista nije dostupna.");
+        viewerMap.read(seatManager.seats);
+        useJournal = false;
+    }
+
+    // Stanje sedista prezivljava pad programa: checkpoint + rep zurnala
+    SeatJournal journal;
+    if (useJournal && journal.open("seats")) {
+        journal.recover(seatManager);
+        seatManager.journal = &journal;
+    }
+
+    // Reprodukcija krece od stanja sala sa pocetka snimka, snimanje belezi trenutno stanje
+    ReplayConfig recordConfig;
+    InputRecorder recorder;
+    if (replay.isOpen()) {
+        if (replay.config.initialSeats.size() != seatManager.seats.size()) return endProgram("Snimak je za drugu salu.");
+        for (size_t i = 0; i < seatManager.seats.size(); i++) seatManager.seats[i].state = (SeatState)replay.config.initialSeats[i];
+    }
+    else if (!recordPath.empty()) {
+        recordConfig.seed = seed;
+        recordConfig.doorCount = (int)personManager.doors.size();
+        recordConfig.flowField = useFlowField;
+        recordConfig.compact = compactPeople;
+        recordConfig.arrivals = arrivals;
+        recordConfig.lod = lod && !useFlowField;
+        recordConfig.focus = lodFocus;
+        for (const Seat& s : seatManager.seats) recordConfig.initialSeats.push_back((uint8_t)s.state);
+        recorder.open(recordPath, recordConfig);
+    }
+
+    // Polja toka od svakih vrata, zajednicka za sve ljude u sali
+    HallNavigation hallNav;
+    if (useFlowField) {
+        hallNav.build(seatManager.seats, personManager.doors);
+        personManager.nav = &hallNav;
+    }
+    if (lod && useFlowField) std::cout << "UPOZORENJE: Nivo detalja radi samo bez polja toka, iskljucen." << std::endl;
+    personManager.lod = lod && !useFlowField;
+    personManager.focus = lodFocus;
+
+    // Tok promena sedista - renderer osvezava samo sedista koja su se promenila
+    SeatEventStream seatEvents;
+    seatManager.events = &seatEvents;
+
+    // Renderer i spawnPeople citaju nepromenljiv snimak sale, nikad ziv seatManager
+    SeatSnapshotStore seatSnapshots;
+    seatSnapshots.publish(seatManager);
+    int renderReader = seatSnapshots.registerReader();
+
+    SeatRenderer seatRenderer;
+    seatRenderer.init(VBO, *seatSnapshots.read(renderReader), seatEvents);
+
+    // Sve ostalo (platno, vrata, ljudi, zavesa, potpis) ide kroz batch
+    SpriteBatch batch;
+    batch.init(VBO, uInstancedLoc);
+    SpriteBatchStats statsTotal;
+    int statsFrames = 0;
+    glBindVertexArray(VAO);
+
+    // Crtanje u petlji ide kroz cache stanja: GL dobija samo stvarne promene
+    GlStateCache gl;
+    GlStateCounters statsGl;
+
+    // Opciono: scena ostaje u framebuffer-u, a svaki frejm se ponovo crtaju samo promenjeni delovi
+    RetainedFrame retained;
+    if (dirtyRects && !retained.init(width, height)) dirtyRects = false;
+
+    // Opciono: rezervacije stizu i od drugih procesa, ne samo sa tastature i misa
+    BookingService bookingService;
+    std::atomic<bool> bookingOpen(true);
+    if (onDemand) bookingService.onApplied = []() { glfwPostEmptyEvent(); };
+    if (!bookingSocket.empty() && bookingService.start(bookingSocket) && bookingThread) {
+        bookingService.startThread(seatManager, seatSnapshots, bookingOpen);
+    }
+
+    SeatSharedMapWriter sharedMap;
+    if (!sharedMapName.empty()) sharedMap.create(sharedMapName, seatManager, seatEvents);
+
+    // Jedan korak simulacije sa ulazom tog frejma (zivim ili iz snimka).
+    // Sve izmene sedista rade pod istim mutex-om kao servis na svojoj niti.
+    auto simulateFrame = [&](double dt, double now, const std::vector<InputEvent>& input) {
+        bool startRequested = false;
+        {
+            std::lock_guard<std::mutex> lock(seatSnapshots.writerMutex);
+
+            if (viewerMap.isOpen()) {
+                // Prenosimo samo promenjena stanja, renderer ih dobija kroz tok promena
+                bool wasStalled = viewerMap.stalled;
+                if (viewerMap.read(viewerSeats) && viewerSeats.size() == seatManager.seats.size()) {
+                    for (int i = 0; i < (int)viewerSeats.size(); i++) seatManager.setSeatState(i, viewerSeats[i].state);
+                }
+                if (viewerMap.stalled != wasStalled) {
+                    std::cout << (viewerMap.stalled ? "UPOZORENJE: Kiosk ne zavrsava upis u deljenu mapu, prikazuje se poslednje stanje."
+                        : "Deljena mapa sedista ponovo se osvezava.") << std::endl;
+                }
+            }
+            for (const InputEvent& e : input) {
+                if (seatManager.applyInput(e)) startRequested = true;
+            }
+
+            if (!bookingThread) bookingService.poll(seatManager, 0, simulator.currentState == IDLE);
+
+            simulator.update(dt, personManager, seatManager);
+            seatManager.flushJournal(now);
+            sharedMap.publish(seatManager);
+            seatSnapshots.publish(seatManager);
+
+            // Pocetak projekcije i zatvaranje rezervacija pod istim mutex-om: servis na svojoj niti
+            // ne moze da potvrdi rezervaciju koju spawnPeople vise ne bi video
+            if (startRequested) simulator.startProjection(personManager, seatManager.seats);
+            bookingOpen = simulator.currentState == IDLE;
+        }
+    };
+
+    std::vector<InputEvent> frameInput;
+    float replayDt = 0.0f;
+    bool replayPending = false; // frejm je procitan iz snimka, ali jos nije odigran
+    double replayBudget = 0.0;
 
     double lastTime = glfwGetTime();
 
+    // Rezim na zahtev: sta je poslednje nacrtano i koliko je petlja spavala
+    glfwSetWindowRefreshCallback(window, onWindowRefresh);
+    if (onDemand) {
+        // Klik ili taster pritisnut i pusten dok petlja spava ne sme da se izgubi (ulaz se cita stanjem)
+        glfwSetInputMode(window, GLFW_STICKY_KEYS, GLFW_TRUE);
+        glfwSetInputMode(window, GLFW_STICKY_MOUSE_BUTTONS, GLFW_TRUE);
+    }
+    uint64_t renderedEvents = 0;
+    SimState renderedState = EXITING;
+    bool sleepIdle = false;
+    uint64_t framesRendered = 0, framesSkipped = 0;
+    double sleptTime = 0.0;
+
     while (!glfwWindowShouldClose(window)) {
 
+        if (sleepIdle) {
+            // Budi ga ulaz, servis (glfwPostEmptyEvent) ili prvi rok: zurnal, provera servisa/displeja
+            double now = glfwGetTime();
+            double timeout = ON_DEMAND_MAX_SLEEP;
+            if (viewerMap.isOpen() || shaderWatcher.isOpen() || (bookingService.isRunning() && !bookingThread)) timeout = ON_DEMAND_POLL_INTERVAL;
+            double deadline;
+            {
+                // Servis na svojoj niti dopisuje u zurnal pod istim mutex-om
+                std::lock_guard<std::mutex> lock(seatSnapshots.writerMutex);
+                deadline = journal.commitDeadline(now);
+            }
+            if (deadline >= 0.0) timeout = std::min(timeout, std::max(deadline - now, 0.0));
+            glfwWaitEventsTimeout(timeout);
+            sleptTime += glfwGetTime() - now;
+            sleepIdle = false;
+            lastTime = glfwGetTime() - TARGET_FRAME_TIME; // vreme spavanja se ne simulira
+        }
+
         double nowTime = glfwGetTime();
         double deltaTime = nowTime - lastTime;
-        if (deltaTime < TARGET_FRAME_TIME) continue;
+        if (deltaTime < TARGET_FRAME_TIME) {
+            if (onDemand) glfwWaitEventsTimeout(TARGET_FRAME_TIME - deltaTime); // bez vrtenja u prazno
+            continue;
+        }
         lastTime = nowTime;
 
         glfwPollEvents();
@@ -97,70 +454,187 @@ int main() {
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, true);
 
-        if (simulator.currentState == IDLE) {
-            int w, h;
-            glfwGetWindowSize(window, &w, &h);
-            seatManager.processMouseInput(window, w, h);
-            seatManager.processKeyboardInput(window);
+        if (replay.isOpen()) {
+            // Snimljeni frejmovi se odigravaju sa svojim dt (bit-tacno), a replaySpeed odredjuje
+            // samo koliko ih stane u jedan prikazani frejm
+            replayBudget += deltaTime * replaySpeed;
+            while (true) {
+                if (!replayPending) {
+                    replayPending = replay.nextFrame(replayDt, frameInput);
+                    if (!replayPending) {
+                        uint64_t hash = simulationHash(seatManager, personManager, simulator);
+                        std::cout << "Reprodukcija gotova: " << replay.frames << " frejmova. ";
+                        if (!replay.hasFinalHash) std::cout << "Snimak nije uredno zatvoren." << std::endl;
+                        else if (hash == replay.finalHash) std::cout << "Krajnje stanje se poklapa sa snimljenim." << std::endl;
+                        else std::cout << "GRESKA: Krajnje stanje se razlikuje od snimljenog!" << std::endl;
+                        replay.close();
+                        break;
+                    }
+                }
+                if (replaySpeed > 0.0 && replayDt > replayBudget) break;
+                if (replaySpeed <= 0.0 && glfwGetTime() - nowTime > TARGET_FRAME_TIME) break;
+                replayBudget -= replayDt;
+                replayPending = false;
+                simulateFrame(replayDt, nowTime, frameInput);
+            }
+        }
+        else {
+            frameInput.clear();
+            if (!viewerMap.isOpen() && simulator.currentState == IDLE) {
+                int w, h;
+                glfwGetWindowSize(window, &w, &h);
+                seatManager.pollInput(window, w, h, frameInput);
+            }
+            if (recorder.isOpen()) {
+                deltaTime = (float)deltaTime; // simulira se tacno ono sto je snimljeno
+                recorder.frame((float)deltaTime, frameInput);
+            }
+            simulateFrame(deltaTime, nowTime, frameInput);
+        }
 
-            if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
-                simulator.startProjection(personManager, seatManager);
+        SeatSnapshotStore::ReadGuard hall = seatSnapshots.read(renderReader);
+
+        // Razvojni rezim: izmenjeni sejderi se prevode i povezuju bez restarta; sa greskom ostaje stari program
+        if (shaderWatcher.changed(nowTime)) {
+            unsigned int reloaded = createShaderFromFiles("basic.vert", "basic.frag");
+            if (reloaded != 0) {
+                glDeleteProgram(shaderProgram);
+                shaderProgram = reloaded;
+                setupProgram();
+                batch.setInstancedLocation(uInstancedLoc);
+                gl.invalidate();
+                if (dirtyRects) retained.invalidate();
+                windowDamaged = true;
+                std::cout << "Sejderi ponovo ucitani." << std::endl;
             }
         }
 
-        simulator.update(deltaTime, personManager, seatManager);
+        // Slike koje su u medjuvremenu dekodirane idu u atlas (mimo cache-a stanja)
+        int texturesArrived = atlas.poll();
+        if (texturesArrived > 0) {
+            gl.invalidate();
+            if (dirtyRects) retained.invalidate();
+        }
 
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
+        // Na zahtev: u IDLE se crta samo ako se sala promenila od poslednjeg crtanja
+        bool render = !onDemand || windowDamaged || texturesArrived > 0 || replay.isOpen() || simulator.currentState != IDLE
+            || renderedState != IDLE || seatEvents.published() != renderedEvents;
+        if (onDemand && !replay.isOpen() && simulator.currentState == IDLE) sleepIdle = true;
+        if (!render) {
+            framesSkipped++;
+            continue;
+        }
+        renderedEvents = seatEvents.published();
+        renderedState = simulator.currentState;
+        windowDamaged = false;
+        framesRendered++;
 
-        // 1. Platno
-        simulator.drawScreen(uPosLoc, uSizeLoc, uColorLoc, uUseTextureLoc);
+        gl.useProgram(shaderProgram);
 
-        // 2. Vrata (Sada koristi teksture unutar funkcije)
-        simulator.drawDoors(uPosLoc, uSizeLoc, uColorLoc, uUseTextureLoc);
+        batch.begin();
 
-        // 3. Sedista
-        // Iskljucujemo teksture pre crtanja sedista jer ona koriste boju
-        glUniform1i(uUseTextureLoc, 0);
-        for (const Seat& s : seatManager.seats) {
-            if (s.state == RESERVED) glUniform4f(uColorLoc, 1.0f, 1.0f, 0.0f, 1.0f);
-            else if (s.state == SOLD) glUniform4f(uColorLoc, 0.8f, 0.0f, 0.0f, 1.0f);
-            else glUniform4f(uColorLoc, 0.0f, 0.6f, 1.0f, 1.0f);
+        // 1. Platno
+        simulator.drawScreen(batch);
 
-            glUniform2f(uPosLoc, s.x, s.y);
-            glUniform2f(uSizeLoc, s.width, s.height);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-        }
+        // 2. Vrata
+        simulator.drawDoors(personManager.doors, batch);
+        batch.split(); // sedista idu preko platna i vrata
+
+        // 3. Sedista - jedan instancirani poziv izmedju dva dela batch-a (crta se ispod)
 
         // 4. Ljudi
         if (simulator.currentState != IDLE) {
-            personManager.draw(shaderProgram, uPosLoc, uSizeLoc, uColorLoc, uUseTextureLoc);
+            personManager.draw(batch);
         }
 
         // 5. Overlay (Zavesa)
         if (simulator.shouldDrawOverlay()) {
-            glUniform1i(uUseTextureLoc, 0);
-            glUniform4f(uColorLoc, 0.0f, 0.0f, 0.0f, 0.6f);
-            glUniform2f(uPosLoc, -1.0f, -1.0f);
-            glUniform2f(uSizeLoc, 2.0f, 2.0f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+            batch.nextLayer();
+            batch.drawRect(-1.0f, -1.0f, 2.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.6f);
         }
 
         // 6. Potpis
-        if (texturePotpis != 0) {
-            glUniform1i(uUseTextureLoc, 1);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, texturePotpis);
-            glUniform4f(uColorLoc, 1.0f, 1.0f, 1.0f, 0.8f);
-            glUniform2f(uPosLoc, 0.5f, -0.9f);
-            glUniform2f(uSizeLoc, 0.45f, 0.2f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+        if (spritePotpis.texture != 0) {
+            batch.nextLayer();
+            batch.draw(spritePotpis, 0.5f, -0.9f, 0.45f, 0.2f, 1.0f, 1.0f, 1.0f, 0.8f);
+        }
+
+        // Na GPU idu samo promenjena sedista; batch se salje jednim upisom
+        seatRenderer.update(*hall, gl);
+        batch.prepare(gl);
+        auto drawScene = [&]() {
+            batch.submit(gl, 0);
+            seatRenderer.draw(gl, uInstancedLoc);
+            batch.submit(gl, 1);
+        };
+
+        if (dirtyRects) {
+            // Prljavo je ono sto se pomerilo ili promenilo u batch-u (stara i nova pozicija) i
+            // sedista iz toka promena
+            int fbWidth, fbHeight;
+            glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+            if (retained.resize(fbWidth, fbHeight)) gl.invalidate();
+            batch.forEachChanged([&](float x, float y, float w, float h) { retained.addNdc(x, y, w, h); });
+            for (int seat : seatRenderer.changedSeats) {
+                const Seat& s = hall->seats[seat];
+                retained.addNdc(s.x, s.y, s.width, s.height);
+            }
+            if (seatRenderer.refreshedAll) retained.invalidate();
+            retained.render(batch.runCount() + 1, drawScene);
+        }
+        else {
+            glClear(GL_COLOR_BUFFER_BIT);
+            drawScene();
         }
 
         glfwSwapBuffers(window);
+        if (framesRendered == 1) std::cout << "Prvi frejm: " << glfwGetTime() * 1000.0 << " ms od pokretanja" << std::endl;
+
+        if (renderStats) {
+            statsTotal.quads += batch.frame.quads;
+            statsTotal.draws += batch.frame.draws;
+            statsTotal.bytes += batch.frame.bytes;
+            if (++statsFrames == 300) {
+                std::cout << "Crtanje (prosek po frejmu): " << statsTotal.quads / statsFrames << " pravougaonika, "
+                    << statsTotal.draws / statsFrames << " poziva (+1 za sedista), "
+                    << statsTotal.bytes / statsFrames << " B na GPU" << std::endl;
+                std::cout << "  Stanje GL (po frejmu): " << (gl.counters.totalIssued() - statsGl.totalIssued()) / statsFrames
+                    << " poziva, " << (gl.counters.totalSkipped() - statsGl.totalSkipped()) / statsFrames << " suvisnih preskoceno"
+                    << std::endl;
+                if (dirtyRects) {
+                    uint64_t frames = retained.framesFull + retained.framesPartial + retained.framesClean;
+                    uint64_t pixels = retained.pixelsDrawn + retained.pixelsSaved;
+                    std::cout << "  Delimicno crtanje: " << retained.framesFull << " celih, " << retained.framesPartial
+                        << " delimicnih, " << retained.framesClean << " bez promena od " << frames << " frejmova; "
+                        << (pixels > 0 ? retained.pixelsDrawn * 100 / pixels : 0) << "% piksela, "
+                        << retained.drawsIssued << "/" << retained.drawsFull << " poziva" << std::endl;
+                }
+                statsGl = gl.counters;
+                statsTotal = SpriteBatchStats();
+                statsFrames = 0;
+            }
+        }
     }
 
+    if (onDemand) {
+        double total = glfwGetTime();
+        std::cout << "Na zahtev: nacrtano " << framesRendered << " frejmova, preskoceno " << framesSkipped << ", spavanje "
+            << sleptTime << " s (" << (total > 0.0 ? sleptTime * 100.0 / total : 0.0) << "% vremena)" << std::endl;
+    }
+    ImageCacheStats imageStats = imageCacheStats();
+    if (imageStats.hits + imageStats.misses > 0) {
+        std::cout << "Kes slika: " << imageStats.hits << " pogodaka (" << imageStats.hitTime * 1000.0 << " ms), "
+            << imageStats.misses << " promasaja (dekodiranje " << imageStats.decodeTime * 1000.0 << " ms), usteda "
+            << imageStats.savedTime * 1000.0 << " ms" << std::endl;
+    }
+    if (recorder.isOpen()) recorder.close(simulationHash(seatManager, personManager, simulator));
+    bookingService.stop();
+    sharedMap.close();
+    journal.close();
+
+    seatRenderer.destroy();
+    batch.destroy();
+    if (dirtyRects) retained.destroy();
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteProgram(shaderProgram);
@@ -0,0 +1,199 @@
+#include "../Header/MonteCarlo.h"
+#include "../Header/SeatManager.h"
+#include "../Header/PersonManager.h"
+#include "../Header/FlowField.h"
+#include "../Header/DoorAssignment.h"
+#include "../Header/CounterRng.h"
+#include "../Header/StreamingStats.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Ciklus koji ne zavrsi za ovoliko koraka (neko ne moze da stigne do sedista) se ne racuna
+const int MONTE_CARLO_MAX_TICKS = 1000000;
+
+struct CycleResult {
+    float fill;  // < 0: ciklus nije zavrsen
+    float empty;
+    int people;
+};
+
+// Stanje koje dele niti: rezultati se upisuju po rednom broju ciklusa, a glavna nit ih
+// sabira redom - odluka o zaustavljanju ne zavisi od toga koja nit je bila brza
+struct MonteCarloRun {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<CycleResult> results;
+    std::vector<uint8_t> done;
+    std::atomic<int> next;
+    std::atomic<int> simulated;
+    std::atomic<bool> stop;
+    int finishedWorkers = 0;
+};
+
+static void monteCarloWorker(const MonteCarloConfig& config, const std::vector<Seat>& hall, const HallNavigation* nav, MonteCarloRun& run) {
+    PersonManager pm(false);
+    pm.doors = defaultDoorLayout(config.doorCount);
+    pm.compact = config.compact;
+    pm.arrivals = config.arrivals;
+    pm.minTurnout = config.minTurnout;
+    pm.nav = const_cast<HallNavigation*>(nav); // tokom kretanja se polje toka samo cita
+    pm.rng.setSeed(config.seed);
+
+    CounterRng rng(config.seed);
+    std::vector<Seat> seats = hall;
+    std::vector<int> order(seats.size());
+    int seatCount = (int)seats.size();
+    int sold = (int)(config.occupancy * seatCount + 0.5);
+    if (sold > seatCount) sold = seatCount;
+
+    while (!run.stop) {
+        int cycle = run.next++;
+        if (cycle >= config.maxCycles) break;
+
+        // Koja sedista su prodata u ovom ciklusu (delimicni Fisher-Yates)
+        for (int i = 0; i < seatCount; i++) {
+            order[i] = i;
+            seats[i].state = FREE;
+        }
+        for (int i = 0; i < sold; i++) {
+            int j = i + (int)rng.below(seatCount - i, RNG_STREAM_OCCUPANCY, cycle, i);
+            std::swap(order[i], order[j]);
+            seats[order[i]].state = SOLD;
+        }
+
+        pm.projection = (uint64_t)cycle; // spawnPeople uvecava brojac: ciklus i koristi projekciju i + 1
+        pm.spawnPeople(seats);
+
+        CycleResult r;
+        r.people = (int)(pm.count() + pm.pendingArrivals());
+        int ticks = 0;
+        while (!pm.areAllSeated() && ticks < MONTE_CARLO_MAX_TICKS) {
+            ticks += pm.skipIdle(config.dt); // dugi prozor dolaska: prazni koraci se ne racunaju
+            pm.update((float)config.dt);
+            ticks++;
+        }
+        r.fill = pm.clock;
+        pm.startExit();
+        while (!pm.areAllGone() && ticks < MONTE_CARLO_MAX_TICKS) {
+            pm.update((float)config.dt);
+            ticks++;
+        }
+        r.empty = pm.clock;
+        if (r.people == 0) r.fill = r.empty = 0.0f; // niko nije dosao, sat nije ni krenuo
+        if (ticks >= MONTE_CARLO_MAX_TICKS) {
+            r.fill = -1.0f;
+            pm.clear();
+        }
+        run.simulated++;
+
+        std::lock_guard<std::mutex> lock(run.mutex);
+        run.results[cycle] = r;
+        run.done[cycle] = 1;
+        run.ready.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(run.mutex);
+    run.finishedWorkers++;
+    run.ready.notify_one();
+}
+
+static bool precise(const RunningStats& s, const MonteCarloConfig& config) {
+    return s.halfWidth(config.z) <= config.precision * s.mean();
+}
+
+static void printMetric(const char* name, const RunningStats& s, const P2Quantile* quantiles, int quantileCount, double z) {
+    std::cout << name << ": " << s.mean() << " s +- " << s.halfWidth(z) << " (sd " << s.stddev() << ", min " << s.min();
+    for (int i = 0; i < quantileCount; i++) {
+        std::cout << ", p" << (int)(quantiles[i].quantile() * 100.0 + 0.5) << " " << quantiles[i].value();
+    }
+    std::cout << ", max " << s.max() << ")" << std::endl;
+}
+
+int runMonteCarlo(const MonteCarloConfig& config) {
+    if (config.occupancy < 0.0 || config.occupancy > 1.0) {
+        std::cout << "GRESKA: Popunjenost mora biti izmedju 0 i 1." << std::endl;
+        return -1;
+    }
+    if (config.minTurnout < 0.0f || config.minTurnout > 1.0f) {
+        std::cout << "GRESKA: Udeo kupaca koji dolazi mora biti izmedju 0 i 1." << std::endl;
+        return -1;
+    }
+    int threads = config.threads > 0 ? config.threads : (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+
+    SeatManager sm;
+    HallNavigation nav;
+    if (config.flowField) nav.build(sm.seats, defaultDoorLayout(config.doorCount));
+
+    std::cout << "Monte Karlo: " << sm.seats.size() << " sedista, popunjenost " << config.occupancy * 100.0 << "%";
+    if (config.minTurnout < 1.0f) std::cout << " prodato (dolazi " << config.minTurnout * 100.0 << "-100% kupaca)";
+    std::cout << ", " << config.doorCount << " vrata, " << threads << " niti, cilj +-" << config.precision * 100.0 << "% (z = "
+        << config.z << ")" << std::endl;
+
+    MonteCarloRun run;
+    run.results.resize(config.maxCycles);
+    run.done.assign(config.maxCycles, 0);
+    run.next = 0;
+    run.simulated = 0;
+    run.stop = false;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::thread(monteCarloWorker, std::cref(config), std::cref(sm.seats),
+            config.flowField ? &nav : (const HallNavigation*)NULL, std::ref(run)));
+    }
+
+    RunningStats fill, empty, people;
+    const double quantiles[] = { 0.5, 0.9, 0.99 };
+    P2Quantile fillQ[3] = { P2Quantile(quantiles[0]), P2Quantile(quantiles[1]), P2Quantile(quantiles[2]) };
+    P2Quantile emptyQ[3] = { P2Quantile(quantiles[0]), P2Quantile(quantiles[1]), P2Quantile(quantiles[2]) };
+    int consumed = 0;
+    int failed = 0;
+    bool converged = false;
+    {
+        std::unique_lock<std::mutex> lock(run.mutex);
+        while (consumed < config.maxCycles && !converged) {
+            run.ready.wait(lock, [&] { return run.done[consumed] || run.finishedWorkers == threads; });
+            if (!run.done[consumed]) break;
+
+            while (consumed < config.maxCycles && run.done[consumed]) {
+                const CycleResult& r = run.results[consumed++];
+                if (r.fill < 0.0f) {
+                    failed++;
+                    continue;
+                }
+                fill.add(r.fill);
+                empty.add(r.empty);
+                people.add(r.people);
+                for (int i = 0; i < 3; i++) {
+                    fillQ[i].add(r.fill);
+                    emptyQ[i].add(r.empty);
+                }
+                if ((int)fill.count() >= config.minCycles && precise(fill, config) && precise(empty, config)) {
+                    converged = true;
+                    break;
+                }
+            }
+        }
+        run.stop = true;
+    }
+    for (std::thread& t : workers) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "Ciklusa: " << consumed << (converged ? " (interval dovoljno uzak)" : " (dostignut maksimum, interval nije dovoljno uzak)")
+        << ", prosecno " << people.mean() << " ljudi (stvarna popunjenost " << people.mean() * 100.0 / sm.seats.size()
+        << "%, trazena " << config.occupancy * 100.0 << "%)" << std::endl;
+    printMetric("Ulazak", fill, fillQ, 3, config.z);
+    printMetric("Izlazak", empty, emptyQ, 3, config.z);
+    if (failed) std::cout << "UPOZORENJE: " << failed << " ciklusa nije zavrseno (neko ne moze do sedista ili vrata)." << std::endl;
+    std::cout << "Vreme: " << elapsed << " s, " << run.simulated / elapsed << " ciklusa/s (" << run.simulated - consumed
+        << " ciklusa odbaceno posle zaustavljanja)" << std::endl;
+    return 0;
+}
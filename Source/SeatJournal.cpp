@@ -0,0 +1,218 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/SeatJournal.h"
+#include "../Header/SeatManager.h"
+
+#include <chrono>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Zaglavlje checkpoint fajla: magic, poslednji seq koji je ukljucen u snimak, broj sedista
+static const uint32_t CHECKPOINT_MAGIC = 0x31504353; // "SCP1"
+
+// fflush samo prazni bafer C biblioteke, tek fsync garantuje da su podaci na disku
+static void syncFile(FILE* f) {
+    fflush(f);
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+// Atomicna zamena fajla: ili ostaje stari checkpoint ili je upisan ceo novi
+static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (std::rename(from.c_str(), to.c_str()) != 0) return false;
+
+    // Sinhronizujemo i direktorijum da bi sama promena imena prezivela pad sistema
+    std::string dir = ".";
+    size_t slash = to.find_last_of('/');
+    if (slash != std::string::npos) dir = to.substr(0, slash);
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+    return true;
+#endif
+}
+
+SeatJournal::SeatJournal() {
+    file = NULL;
+    firstPendingTime = -1.0;
+    nextSeq = 1;
+    recordsSinceCheckpoint = 0;
+}
+
+SeatJournal::~SeatJournal() {
+    close();
+}
+
+bool SeatJournal::open(const std::string& pathPrefix) {
+    close();
+    journalPath = pathPrefix + ".journal";
+    checkpointPath = pathPrefix + ".checkpoint";
+
+    // "ab" - novi zapisi uvek idu na kraj, postojeci sadrzaj se cita tek u recover()
+    file = fopen(journalPath.c_str(), "ab");
+    if (file == NULL) {
+        std::cout << "GRESKA: Zurnal nije otvoren! Putanja: " << journalPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SeatJournal::close() {
+    if (file == NULL) return;
+    commit();
+    fclose(file);
+    file = NULL;
+}
+
+int SeatJournal::recover(SeatManager& sm) {
+    auto t0 = std::chrono::steady_clock::now();
+
+    // 1. Checkpoint
+    uint32_t lastSeq = 0;
+    bool haveCheckpoint = false;
+    bool layoutMismatch = false;
+    FILE* cp = fopen(checkpointPath.c_str(), "rb");
+    if (cp != NULL) {
+        uint32_t header[3];
+        if (fread(header, sizeof(uint32_t), 3, cp) == 3 && header[0] == CHECKPOINT_MAGIC) {
+            if (header[2] == sm.seats.size()) {
+                std::vector<uint8_t> states(header[2]);
+                if (fread(states.data(), 1, states.size(), cp) == states.size()) {
+                    for (size_t i = 0; i < states.size(); i++) sm.seats[i].state = (SeatState)states[i];
+                    lastSeq = header[1];
+                    haveCheckpoint = true;
+                }
+            }
+            else {
+                layoutMismatch = true;
+                std::cout << "UPOZORENJE: Checkpoint je za salu sa " << header[2] << " sedista, ignorisem ga." << std::endl;
+            }
+        }
+        fclose(cp);
+    }
+
+    // 2. Rep zurnala - samo zapisi noviji od checkpoint-a, u neprekinutom nizu
+    int replayed = 0;
+    bool haveJournal = false;
+    FILE* jf = layoutMismatch ? NULL : fopen(journalPath.c_str(), "rb");
+    if (jf != NULL) {
+        JournalRecord r;
+        uint32_t expected = 0;
+        while (fread(&r, sizeof(r), 1, jf) == 1) {
+            if (r.seq <= lastSeq) continue; // vec pokriveno checkpoint-om
+            if (expected != 0 && r.seq != expected) break; // pokidan rep
+            if (expected == 0 && haveCheckpoint && r.seq != lastSeq + 1) break;
+
+            uint32_t seat = r.packed & 0xFFFFFF;
+            SeatState state = (SeatState)(r.packed >> 24);
+            if (seat == JOURNAL_ALL_SEATS) {
+                for (Seat& s : sm.seats) s.state = state;
+            }
+            else if (seat < sm.seats.size()) {
+                sm.seats[seat].state = state;
+            }
+            expected = r.seq + 1;
+            lastSeq = r.seq;
+            replayed++;
+            haveJournal = true;
+        }
+        fclose(jf);
+    }
+
+    nextSeq = lastSeq + 1;
+    pending.clear();
+    firstPendingTime = -1.0;
+
+    // 3. Novi checkpoint odmah - time se odsece eventualni pokidan rep zurnala
+    checkpoint(sm);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (!haveCheckpoint && !haveJournal) return -1;
+    std::cout << "Stanje sedista vraceno iz zurnala (" << replayed << " zapisa) za " << ms << " ms." << std::endl;
+    return replayed;
+}
+
+void SeatJournal::append(uint32_t seatIndex, int newState) {
+    JournalRecord r;
+    r.seq = nextSeq++;
+    r.packed = (seatIndex & 0xFFFFFF) | ((uint32_t)newState << 24);
+    pending.push_back(r);
+    if (pending.size() >= maxBatch) commit();
+}
+
+void SeatJournal::commit() {
+    if (file == NULL || pending.empty()) return;
+    fwrite(pending.data(), sizeof(JournalRecord), pending.size(), file);
+    syncFile(file);
+
+    recordsWritten += pending.size();
+    recordsSinceCheckpoint += (uint32_t)pending.size();
+    syncCount++;
+    pending.clear();
+    firstPendingTime = -1.0;
+}
+
+void SeatJournal::commitIfDue(double now) {
+    if (pending.empty()) return;
+    if (firstPendingTime < 0.0) firstPendingTime = now;
+    if (pending.size() >= maxBatch || now - firstPendingTime >= maxDelay) commit();
+}
+
+bool SeatJournal::checkpoint(const SeatManager& sm) {
+    if (file == NULL) return false;
+
+    // Snimak obuhvata i promene koje su jos u baferu, pa njih vise ne treba upisivati
+    std::string tmpPath = checkpointPath + ".tmp";
+    FILE* cp = fopen(tmpPath.c_str(), "wb");
+    if (cp == NULL) {
+        std::cout << "GRESKA: Checkpoint nije upisan! Putanja: " << tmpPath << std::endl;
+        return false;
+    }
+
+    uint32_t header[3] = { CHECKPOINT_MAGIC, nextSeq - 1, (uint32_t)sm.seats.size() };
+    std::vector<uint8_t> states(sm.seats.size());
+    for (size_t i = 0; i < sm.seats.size(); i++) states[i] = (uint8_t)sm.seats[i].state;
+
+    fwrite(header, sizeof(uint32_t), 3, cp);
+    fwrite(states.data(), 1, states.size(), cp);
+    syncFile(cp);
+    fclose(cp);
+
+    if (!replaceFile(tmpPath, checkpointPath)) {
+        std::cout << "GRESKA: Checkpoint nije zamenjen! Putanja: " << checkpointPath << std::endl;
+        return false;
+    }
+
+    pending.clear();
+    firstPendingTime = -1.0;
+    recordsSinceCheckpoint = 0;
+    checkpointCount++;
+    return truncateJournal();
+}
+
+bool SeatJournal::truncateJournal() {
+    // Ako pukne ovde, oporavak preskace zapise sa seq <= seq iz checkpoint-a
+    fclose(file);
+    file = fopen(journalPath.c_str(), "wb");
+    if (file == NULL) {
+        std::cout << "GRESKA: Zurnal nije ispraznjen! Putanja: " << journalPath << std::endl;
+        return false;
+    }
+    syncFile(file);
+    return true;
+}
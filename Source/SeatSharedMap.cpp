@@ -0,0 +1,235 @@
+#include "../Header/SeatSharedMap.h"
+#include "../Header/SeatManager.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t SHARED_MAP_MAGIC = 0x314D5353; // "SSM1"
+
+// Upis traje mikrosekunde; ovoliko neuspelih pokusaja znaci da je pisac stao usred upisa
+static const int MAX_READ_ATTEMPTS = 100000;
+
+// Mapiranje imenovane deljene memorije; na Windows-u ime ne sme da pocne sa '/'
+static void* mapShared(const std::string& name, size_t size, bool create, void** handle) {
+#ifdef _WIN32
+    std::string winName = "Local\\" + (name.size() && name[0] == '/' ? name.substr(1) : name);
+    HANDLE h = create
+        ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, winName.c_str())
+        : OpenFileMappingA(FILE_MAP_READ, FALSE, winName.c_str());
+    if (h == NULL) return NULL;
+    void* p = MapViewOfFile(h, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (p == NULL) {
+        CloseHandle(h);
+        return NULL;
+    }
+    *handle = h;
+    return p;
+#else
+    *handle = NULL;
+    int fd = create ? shm_open(name.c_str(), O_CREAT | O_RDWR, 0644) : shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    if (create && ftruncate(fd, size) != 0) {
+        ::close(fd);
+        return NULL;
+    }
+    void* p = mmap(NULL, size, create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    return p == MAP_FAILED ? NULL : p;
+#endif
+}
+
+static void unmapShared(void* p, size_t size, void* handle) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(p);
+    CloseHandle((HANDLE)handle);
+#else
+    (void)handle;
+    munmap(p, size);
+#endif
+}
+
+static size_t mapSizeFor(uint32_t seatCount) {
+    return sizeof(SharedSeatMapHeader) + seatCount * sizeof(SharedSeat);
+}
+
+SeatSharedMapWriter::SeatSharedMapWriter() {
+    header = NULL;
+    seats = NULL;
+    mappedSize = 0;
+    handle = NULL;
+}
+
+SeatSharedMapWriter::~SeatSharedMapWriter() {
+    close();
+}
+
+bool SeatSharedMapWriter::create(const std::string& mapName, const SeatManager& sm, SeatEventStream& stream) {
+    close();
+    uint32_t count = (uint32_t)sm.seats.size();
+    mappedSize = mapSizeFor(count);
+
+    void* p = mapShared(mapName, mappedSize, true, &handle);
+    if (p == NULL) {
+        std::cout << "GRESKA: Deljena memorija nije napravljena: " << mapName << std::endl;
+        return false;
+    }
+    name = mapName;
+    header = (SharedSeatMapHeader*)p;
+    seats = (SharedSeat*)(header + 1);
+
+    // Citaoci odbijaju mapu dok je magic 0, pa ga upisujemo poslednjeg
+    header->magic = 0;
+    header->seatCount = count;
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->version = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const Seat& s = sm.seats[i];
+        seats[i].x = s.x; seats[i].y = s.y;
+        seats[i].width = s.width; seats[i].height = s.height;
+        seats[i].state = s.state;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHARED_MAP_MAGIC;
+
+    subscriber.subscribe(stream);
+    dirty.reserve(count);
+    std::cout << "Mapa sedista je deljena kao " << mapName << std::endl;
+    return true;
+}
+
+void SeatSharedMapWriter::close() {
+    if (header == NULL) return;
+    header->magic = 0;
+    unmapShared(header, mappedSize, handle);
+#ifndef _WIN32
+    shm_unlink(name.c_str());
+#endif
+    header = NULL;
+    seats = NULL;
+}
+
+void SeatSharedMapWriter::publish(const SeatManager& sm) {
+    if (header == NULL) return;
+
+    bool all = false;
+    dirty.clear();
+    bool ok = subscriber.poll([&](const SeatEvent& e) {
+        if (e.seat == SEAT_EVENT_ALL || e.seat >= header->seatCount) all = true;
+        else dirty.push_back(e.seat);
+    });
+    if (!ok) all = true;
+    if (!all && dirty.empty()) return;
+
+    // Seqlock: neparan brojac = upis u toku
+    uint32_t seq = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (all) {
+        for (uint32_t i = 0; i < header->seatCount; i++) seats[i].state = sm.seats[i].state;
+    }
+    else {
+        for (uint32_t i : dirty) seats[i].state = sm.seats[i].state;
+    }
+    header->version++;
+
+    header->sequence.store(seq + 2, std::memory_order_release);
+}
+
+SeatSharedMapReader::SeatSharedMapReader() {
+    header = NULL;
+    seats = NULL;
+    mappedSize = 0;
+    handle = NULL;
+    lastVersion = ~0ull;
+}
+
+SeatSharedMapReader::~SeatSharedMapReader() {
+    close();
+}
+
+bool SeatSharedMapReader::open(const std::string& mapName) {
+    close();
+
+    // Prvo samo zaglavlje, da saznamo broj sedista
+    void* handleProbe = NULL;
+    void* probe = mapShared(mapName, sizeof(SharedSeatMapHeader), false, &handleProbe);
+    if (probe == NULL) {
+        std::cout << "GRESKA: Deljena mapa sedista ne postoji: " << mapName << std::endl;
+        return false;
+    }
+    const SharedSeatMapHeader* h = (const SharedSeatMapHeader*)probe;
+    bool valid = h->magic == SHARED_MAP_MAGIC;
+    uint32_t count = h->seatCount;
+    unmapShared(probe, sizeof(SharedSeatMapHeader), handleProbe);
+    if (!valid) {
+        std::cout << "GRESKA: Deljena mapa sedista nije spremna: " << mapName << std::endl;
+        return false;
+    }
+
+    mappedSize = mapSizeFor(count);
+    void* p = mapShared(mapName, mappedSize, false, &handle);
+    if (p == NULL) return false;
+    header = (SharedSeatMapHeader*)p;
+    seats = (const SharedSeat*)(header + 1);
+    lastVersion = ~0ull;
+    return true;
+}
+
+void SeatSharedMapReader::close() {
+    if (header == NULL) return;
+    unmapShared(header, mappedSize, handle);
+    header = NULL;
+    seats = NULL;
+}
+
+bool SeatSharedMapReader::read(std::vector<Seat>& out) {
+    if (header == NULL) return false;
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+        if (attempt > 0) retries++;
+        uint32_t before = header->sequence.load(std::memory_order_acquire);
+        if (before & 1) continue; // pisac je usred upisa
+
+        uint64_t version = header->version;
+        if (version == lastVersion) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (header->sequence.load(std::memory_order_relaxed) == before) {
+                stalled = false;
+                return false;
+            }
+            continue;
+        }
+
+        // Kopija ide u privremeni niz: ako citanje ne uspe, pozivalac zadrzava prethodni snimak
+        uint32_t count = header->seatCount;
+        scratch.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            scratch[i].x = seats[i].x; scratch[i].y = seats[i].y;
+            scratch[i].width = seats[i].width; scratch[i].height = seats[i].height;
+            scratch[i].state = (SeatState)seats[i].state;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) == before) {
+            lastVersion = version;
+            stalled = false;
+            out.swap(scratch);
+            return true;
+        }
+    }
+
+    // Pisac je verovatno pao usred upisa (sekvenca je ostala neparna)
+    stalled = true;
+    return false;
+}
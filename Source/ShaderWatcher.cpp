@@ -0,0 +1,108 @@
+#include "../Header/ShaderWatcher.h"
+#include "../Header/AssetPack.h"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+    std::string directoryOf(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? "." : path.substr(0, slash);
+    }
+
+    std::string nameOf(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+}
+
+ShaderWatcher::ShaderWatcher() {
+    opened = false;
+    fd = -1;
+    lastPoll = 0.0;
+}
+
+ShaderWatcher::~ShaderWatcher() {
+    close();
+}
+
+bool ShaderWatcher::watch(const std::vector<std::string>& paths) {
+    close();
+    files = paths;
+    sizes.assign(files.size(), 0);
+    mtimes.assign(files.size(), 0);
+    for (size_t i = 0; i < files.size(); i++) fileStamp(files[i], sizes[i], mtimes[i]);
+
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) {
+        std::vector<std::string> directories;
+        for (const std::string& f : files) {
+            std::string dir = directoryOf(f);
+            bool seen = false;
+            for (const std::string& d : directories) seen = seen || d == dir;
+            if (seen) continue;
+            directories.push_back(dir);
+            if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+                std::cout << "UPOZORENJE: inotify ne prati " << dir << ", prelazi se na proveru vremena izmene." << std::endl;
+                ::close(fd);
+                fd = -1;
+                break;
+            }
+        }
+    }
+#endif
+    opened = true;
+    std::cout << "Sejderi se prate" << (fd >= 0 ? " (inotify)" : " (vreme izmene)") << ", izmene se ucitavaju odmah." << std::endl;
+    return true;
+}
+
+void ShaderWatcher::close() {
+#ifdef __linux__
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+    opened = false;
+}
+
+bool ShaderWatcher::changed(double now) {
+    if (!opened) return false;
+
+#ifdef __linux__
+    if (fd >= 0) {
+        // Svi dogadjaji od proslog poziva; zanimaju nas samo pracena imena
+        bool hit = false;
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) break;
+            for (char* p = buffer; p < buffer + n;) {
+                const struct inotify_event* e = (const struct inotify_event*)p;
+                if (e->len > 0) {
+                    for (const std::string& f : files) hit = hit || nameOf(f) == e->name;
+                }
+                p += sizeof(struct inotify_event) + e->len;
+            }
+        }
+        return hit;
+    }
+#endif
+
+    if (now - lastPoll < pollInterval) return false;
+    lastPoll = now;
+    bool hit = false;
+    for (size_t i = 0; i < files.size(); i++) {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (!fileStamp(files[i], size, mtime)) continue; // usred snimanja fajla moze na trenutak da nestane
+        if (size != sizes[i] || mtime != mtimes[i]) hit = true;
+        sizes[i] = size;
+        mtimes[i] = mtime;
+    }
+    return hit;
+}
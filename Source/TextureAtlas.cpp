@@ -0,0 +1,428 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/TextureAtlas.h"
+#include "../Header/AssetPack.h"
+#include "../Header/ImageCache.h"
+#include "../Header/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    int roundUp(int v, int step) {
+        return (v + step - 1) / step * step;
+    }
+
+    bool packAll(std::vector<AtlasSlot>& slots, int width, int height) {
+        SkylinePacker packer;
+        packer.init(width, height);
+        for (AtlasSlot& slot : slots) {
+            if (!packer.insert(slot.slotWidth, slot.slotHeight, slot.x, slot.y)) return false;
+        }
+        return true;
+    }
+
+    double secondsNow() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Sledeci nivo mipmape: prosek 2x2 piksela (dimenzije atlasa su stepeni dvojke)
+    std::vector<unsigned char> halve(const std::vector<unsigned char>& src, int w, int h) {
+        int hw = std::max(w / 2, 1), hh = std::max(h / 2, 1);
+        std::vector<unsigned char> dst((size_t)hw * hh * 4);
+        for (int y = 0; y < hh; y++) {
+            for (int x = 0; x < hw; x++) {
+                int x0 = std::min(2 * x, w - 1), x1 = std::min(2 * x + 1, w - 1);
+                int y0 = std::min(2 * y, h - 1), y1 = std::min(2 * y + 1, h - 1);
+                for (int c = 0; c < 4; c++) {
+                    int sum = src[((size_t)y0 * w + x0) * 4 + c] + src[((size_t)y0 * w + x1) * 4 + c]
+                        + src[((size_t)y1 * w + x0) * 4 + c] + src[((size_t)y1 * w + x1) * 4 + c];
+                    dst[((size_t)y * hw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        return dst;
+    }
+
+    uint64_t alignUp(uint64_t v) {
+        return (v + ASSET_PACK_ALIGN - 1) / ASSET_PACK_ALIGN * ASSET_PACK_ALIGN;
+    }
+}
+
+// Raspored slika u atlasu samo iz zaglavlja slika (velicina); sprajtovi dobijaju UV, ali jos ne teksturu
+bool TextureAtlas::layout(const std::vector<std::string>& files, int maxSize) {
+    names = files;
+    sprites.assign(files.size(), Sprite());
+    int pad = 1 << maxLevel;
+
+    // Za raspored je dovoljno zaglavlje slike (velicina), dekodira se kasnije
+    slots.clear();
+    long long area = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        AtlasSlot slot;
+        int channels;
+        if (!stbi_info(files[i].c_str(), &slot.width, &slot.height, &channels)) {
+            std::cout << "Textura nije ucitana! Putanja texture: " << files[i] << std::endl;
+            continue;
+        }
+        slot.index = (int)i;
+        slot.file = files[i];
+        slot.slotWidth = roundUp(slot.width + 2 * pad, pad);
+        slot.slotHeight = roundUp(slot.height + 2 * pad, pad);
+        slot.x = slot.y = 0;
+        area += (long long)slot.slotWidth * slot.slotHeight;
+        slots.push_back(slot);
+    }
+    if (slots.empty()) return false;
+
+    // Visi prvo: skyline tako ostavlja najmanje rupa
+    std::sort(slots.begin(), slots.end(), [](const AtlasSlot& a, const AtlasSlot& b) {
+        return a.slotHeight != b.slotHeight ? a.slotHeight > b.slotHeight : a.slotWidth > b.slotWidth;
+    });
+
+    // Najmanja tekstura (stepen dvojke, sirina = visina ili 2x visina) u koju sve staje
+    bool packed = false;
+    for (int w = 64; w <= maxSize && !packed; w *= 2) {
+        for (int h = w / 2; h <= w && !packed; h *= 2) {
+            if ((long long)w * h < area) continue;
+            packed = packAll(slots, w, h);
+            width = w;
+            height = h;
+        }
+    }
+    if (!packed) {
+        std::cout << "GRESKA: Slike ne staju u atlas (najvise " << maxSize << "x" << maxSize << ")." << std::endl;
+        slots.clear();
+        return false;
+    }
+
+    for (const AtlasSlot& slot : slots) {
+        Sprite& s = sprites[slot.index];
+        s.u = (float)(slot.x + pad) / width;
+        s.v = (float)(slot.y + pad) / height;
+        s.du = (float)slot.width / width;
+        s.dv = (float)slot.height / height;
+    }
+    return true;
+}
+
+bool TextureAtlas::start(const std::vector<std::string>& files, int threads) {
+    startTime = secondsNow();
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (!layout(files, maxSize)) return false;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel); // manji nivoi bi mesali susedne slike
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Zamenska boja: brisanje kroz framebuffer, bez slanja cele teksture sa CPU-a
+    unsigned int fbo;
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glClearColor(placeholder[0], placeholder[1], placeholder[2], placeholder[3]);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (const AtlasSlot& slot : slots) sprites[slot.index].texture = texture;
+
+    long long used = 0;
+    for (const AtlasSlot& slot : slots) used += (long long)slot.width * slot.height;
+    threadsUsed = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+    threadsUsed = std::max(std::min(threadsUsed, (int)slots.size()), 1);
+    std::cout << "Atlas: " << slots.size() << " slika u " << width << "x" << height << " ("
+        << used * 100 / ((long long)width * height) << "% popunjeno), dekodiranje na " << threadsUsed << " niti" << std::endl;
+
+    glGenBuffers(1, &pbo);
+    pending = (int)slots.size();
+    done.clear();
+    decodeTime = readyTime = 0.0;
+    nextSlot = 0;
+    for (int i = 0; i < threadsUsed; i++) workers.push_back(std::thread(&TextureAtlas::decodeWorker, this));
+    return true;
+}
+
+// Slika se upisuje obrnuta (kao u loadImageToTexture), a okvir se popunjava najblizim ivicnim pikselom.
+// Ako slika ne moze da se dekodira, pixels ostaje prazno.
+void TextureAtlas::decodeSlot(AtlasSlot& slot) const {
+    int pad = 1 << maxLevel;
+    int w, h, channels;
+    unsigned char* image = loadImageCached(slot.file.c_str(), &w, &h, &channels, 4, false);
+    if (image == NULL || w != slot.width || h != slot.height) {
+        std::cout << "Textura nije ucitana! Putanja texture: " << slot.file << std::endl;
+    }
+    else {
+        slot.pixels.resize((size_t)slot.slotWidth * slot.slotHeight * 4);
+        for (int sy = 0; sy < slot.slotHeight; sy++) {
+            int row = h - 1 - std::min(std::max(sy - pad, 0), h - 1);
+            unsigned char* dst = &slot.pixels[(size_t)sy * slot.slotWidth * 4];
+            for (int sx = 0; sx < slot.slotWidth; sx++) {
+                int col = std::min(std::max(sx - pad, 0), w - 1);
+                const unsigned char* src = image + ((size_t)row * w + col) * 4;
+                std::copy(src, src + 4, dst + sx * 4);
+            }
+        }
+    }
+    stbi_image_free(image);
+}
+
+// Radna nit: dekodira slike redom dok ih ima
+void TextureAtlas::decodeWorker() {
+    for (;;) {
+        int i = nextSlot++;
+        if (i >= (int)slots.size()) return;
+        double t0 = secondsNow();
+        decodeSlot(slots[i]);
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            decodeTime += secondsNow() - t0;
+            done.push_back(i);
+        }
+        decoded.notify_all();
+        if (onDecoded) onDecoded();
+    }
+}
+
+int TextureAtlas::poll() {
+    if (pending == 0) return 0;
+    std::vector<int> ready;
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        ready.swap(done);
+    }
+    if (ready.empty()) return 0;
+
+    // Kroz pixel buffer: kopija u mapiran bafer je odmah gotova, a prenos u teksturu radi drajver.
+    // Bafer se napusta pre svake slike, pa se ne ceka na prenos prethodne.
+    int uploaded = 0;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    for (int i : ready) {
+        AtlasSlot& slot = slots[i];
+        pending--;
+        if (slot.pixels.empty()) continue;
+        size_t bytes = slot.pixels.size();
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+        void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (dst != NULL) {
+            memcpy(dst, slot.pixels.data(), bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, slot.x, slot.y, slot.slotWidth, slot.slotHeight, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+        }
+        else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, slot.x, slot.y, slot.slotWidth, slot.slotHeight, GL_RGBA, GL_UNSIGNED_BYTE, slot.pixels.data());
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        }
+        std::vector<unsigned char>().swap(slot.pixels);
+        uploaded++;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (uploaded > 0) glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (pending == 0) {
+        joinWorkers();
+        glDeleteBuffers(1, &pbo);
+        pbo = 0;
+        readyTime = secondsNow() - startTime;
+        std::cout << "Atlas: slike spremne za " << readyTime * 1000.0 << " ms (dekodiranje " << decodeTime * 1000.0
+            << " ms ukupno na " << threadsUsed << " niti)" << std::endl;
+    }
+    return uploaded;
+}
+
+void TextureAtlas::finish() {
+    while (pending > 0) {
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            decoded.wait(lock, [this]() { return !done.empty(); });
+        }
+        poll();
+    }
+}
+
+void TextureAtlas::joinWorkers() {
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+}
+
+bool TextureAtlas::writePack(const std::string& path, const std::vector<std::string>& files, int maxSize) {
+    double t0 = secondsNow();
+    if (!layout(files, maxSize)) return false;
+
+    std::vector<std::vector<unsigned char>> levels(1);
+    levels[0].assign((size_t)width * height * 4, 0);
+    std::vector<AssetPackSprite> entries;
+    for (AtlasSlot& slot : slots) {
+        decodeSlot(slot);
+        if (slot.pixels.empty()) continue;
+        for (int r = 0; r < slot.slotHeight; r++) {
+            memcpy(&levels[0][((size_t)(slot.y + r) * width + slot.x) * 4], &slot.pixels[(size_t)r * slot.slotWidth * 4],
+                (size_t)slot.slotWidth * 4);
+        }
+        std::vector<unsigned char>().swap(slot.pixels);
+
+        if (slot.file.size() >= sizeof(AssetPackSprite().name)) {
+            std::cout << "UPOZORENJE: Putanja slike je preduga za paket: " << slot.file << std::endl;
+            continue;
+        }
+        AssetPackSprite entry = {};
+        strcpy(entry.name, slot.file.c_str());
+        const Sprite& s = sprites[slot.index];
+        entry.u = s.u;
+        entry.v = s.v;
+        entry.du = s.du;
+        entry.dv = s.dv;
+        fileStamp(slot.file, entry.sourceSize, entry.sourceTime);
+        entries.push_back(entry);
+    }
+    for (int l = 1; l <= maxLevel; l++) {
+        levels.push_back(halve(levels[l - 1], std::max(width >> (l - 1), 1), std::max(height >> (l - 1), 1)));
+    }
+
+    AssetPackHeader header = {};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.width = width;
+    header.height = height;
+    header.levels = (uint32_t)levels.size();
+    header.spriteCount = (uint32_t)entries.size();
+    header.format = ASSET_PACK_RGBA8;
+
+    std::vector<AssetPackLevel> table(levels.size());
+    uint64_t offset = sizeof(header) + entries.size() * sizeof(AssetPackSprite) + table.size() * sizeof(AssetPackLevel);
+    for (size_t l = 0; l < levels.size(); l++) {
+        table[l].width = std::max(width >> l, 1);
+        table[l].height = std::max(height >> l, 1);
+        table[l].offset = alignUp(offset);
+        table[l].size = levels[l].size();
+        offset = table[l].offset + table[l].size;
+    }
+
+    // Upis u privremeni fajl pa zamena: aplikacija nikad ne mapira polovican paket
+    std::string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (file == NULL) {
+        std::cout << "GRESKA: Paket slika nije upisan! Putanja: " << tmpPath << std::endl;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (!entries.empty()) ok = ok && fwrite(entries.data(), sizeof(AssetPackSprite), entries.size(), file) == entries.size();
+    ok = ok && fwrite(table.data(), sizeof(AssetPackLevel), table.size(), file) == table.size();
+    for (size_t l = 0; l < levels.size() && ok; l++) {
+        std::vector<unsigned char> padding((size_t)(table[l].offset - ftell(file)), 0);
+        if (!padding.empty()) ok = fwrite(padding.data(), 1, padding.size(), file) == padding.size();
+        ok = ok && fwrite(levels[l].data(), 1, levels[l].size(), file) == levels[l].size();
+    }
+    ok = fclose(file) == 0 && ok;
+    remove(path.c_str());
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cout << "GRESKA: Paket slika nije upisan! Putanja: " << path << std::endl;
+        remove(tmpPath.c_str());
+        return false;
+    }
+    std::cout << "Paket slika: " << entries.size() << " slika, atlas " << width << "x" << height << ", " << levels.size()
+        << " nivoa, " << offset / 1024 << " KB, za " << (secondsNow() - t0) * 1000.0 << " ms -> " << path << std::endl;
+    return true;
+}
+
+bool TextureAtlas::loadPack(const std::string& path, const std::vector<std::string>& files) {
+    double t0 = secondsNow();
+    MappedFile pack;
+    if (!pack.open(path)) return false;
+
+    const unsigned char* base = pack.bytes();
+    const AssetPackHeader* header = (const AssetPackHeader*)base;
+    bool valid = pack.size() >= sizeof(AssetPackHeader) && header->magic == ASSET_PACK_MAGIC
+        && header->version == ASSET_PACK_VERSION && header->format == ASSET_PACK_RGBA8 && header->levels > 0
+        && sizeof(AssetPackHeader) + (uint64_t)header->spriteCount * sizeof(AssetPackSprite)
+            + (uint64_t)header->levels * sizeof(AssetPackLevel) <= pack.size();
+    if (!valid) {
+        std::cout << "UPOZORENJE: Paket slika nije ispravan, ucitavaju se slike: " << path << std::endl;
+        return false;
+    }
+    const AssetPackSprite* entries = (const AssetPackSprite*)(base + sizeof(AssetPackHeader));
+    const AssetPackLevel* table = (const AssetPackLevel*)(entries + header->spriteCount);
+    for (uint32_t l = 0; l < header->levels; l++) {
+        const AssetPackLevel& level = table[l];
+        if (level.offset + level.size > pack.size() || level.size != (uint64_t)level.width * level.height * 4) {
+            std::cout << "UPOZORENJE: Paket slika nije ispravan, ucitavaju se slike: " << path << std::endl;
+            return false;
+        }
+    }
+
+    // Slika na disku koja se promenila (ili koje nema u paketu) znaci da je paket zastareo.
+    // Slike kojih nema na disku se uzimaju iz paketa (kiosk moze da ima samo paket).
+    std::vector<const AssetPackSprite*> found(files.size(), NULL);
+    for (size_t i = 0; i < files.size(); i++) {
+        for (uint32_t e = 0; e < header->spriteCount; e++) {
+            if (strncmp(entries[e].name, files[i].c_str(), sizeof(entries[e].name)) == 0) found[i] = &entries[e];
+        }
+        uint64_t size;
+        int64_t mtime;
+        if (!fileStamp(files[i], size, mtime)) continue;
+        if (found[i] == NULL || found[i]->sourceSize != size || found[i]->sourceTime != mtime) {
+            std::cout << "UPOZORENJE: Paket slika je zastareo (" << files[i] << "), ucitavaju se slike." << std::endl;
+            return false;
+        }
+    }
+
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if ((GLint)header->width > maxSize || (GLint)header->height > maxSize) {
+        std::cout << "UPOZORENJE: Atlas iz paketa je veci od " << maxSize << "x" << maxSize << ", ucitavaju se slike." << std::endl;
+        return false;
+    }
+
+    // Nivoi idu na GPU direktno iz mapiranog fajla: bez dekodiranja, obrtanja i kopije na CPU-u
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    for (uint32_t l = 0; l < header->levels; l++) {
+        glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA, table[l].width, table[l].height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+            base + table[l].offset);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header->levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    width = header->width;
+    height = header->height;
+    maxLevel = header->levels - 1;
+    names = files;
+    sprites.assign(files.size(), Sprite());
+    slots.clear();
+    pending = 0;
+    int loaded = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (found[i] == NULL) continue;
+        Sprite& s = sprites[i];
+        s.texture = texture;
+        s.u = found[i]->u;
+        s.v = found[i]->v;
+        s.du = found[i]->du;
+        s.dv = found[i]->dv;
+        loaded++;
+    }
+    readyTime = secondsNow() - t0;
+    std::cout << "Atlas: " << loaded << " slika iz paketa " << path << " (" << width << "x" << height << ") za "
+        << readyTime * 1000.0 << " ms" << std::endl;
+    return true;
+}
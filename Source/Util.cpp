@@ -1,9 +1,23 @@
 #include "../Header/Util.h";
+#include "../Header/ImageCache.h"
+#include "../Header/EmbeddedShaders.h"
 
 #define _CRT_SECURE_NO_WARNINGS
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../Header/stb_image.h"
@@ -18,25 +32,39 @@ int endProgram(std::string message) {
     return -1;
 }
 
-unsigned int compileShader(GLenum type, const char* source)
+// Izvorni kod sejdera: ugradjen u program (EmbeddedShaders.h, bez citanja sa diska) ili iz fajla.
+// Vraca false ako koda nema ni na jednom mestu.
+static bool readShaderSource(const char* source, bool fromFile, std::string& out)
 {
-    //Uzima kod u fajlu na putanji "source", kompajlira ga i vraca sejder tipa "type"
-    //Citanje izvornog koda iz fajla
-    std::string content = "";
-    std::ifstream file(source);
-    std::stringstream ss;
-    if (file.is_open())
+    if (!fromFile)
     {
-        ss << file.rdbuf();
-        file.close();
-        std::cout << "Uspjesno procitao fajl sa putanje \"" << source << "\"!" << std::endl;
+        for (const EmbeddedShader& embedded : EMBEDDED_SHADERS)
+        {
+            if (strcmp(embedded.name, source) == 0)
+            {
+                out = embedded.source;
+                return true;
+            }
+        }
     }
-    else {
-        ss << "";
+    std::ifstream file(source);
+    if (!file.is_open())
+    {
         std::cout << "Greska pri citanju fajla sa putanje \"" << source << "\"!" << std::endl;
+        return false;
     }
-    std::string temp = ss.str();
-    const char* sourceCode = temp.c_str(); //Izvorni kod sejdera koji citamo iz fajla na putanji "source"
+    std::stringstream ss;
+    ss << file.rdbuf();
+    file.close();
+    out = ss.str();
+    std::cout << "Uspjesno procitao fajl sa putanje \"" << source << "\"!" << std::endl;
+    return true;
+}
+
+unsigned int compileShader(GLenum type, const std::string& code)
+{
+    //Kompajlira izvorni kod "code" i vraca sejder tipa "type"; 0 ako kompajliranje nije uspjelo
+    const char* sourceCode = code.c_str(); //Izvorni kod sejdera
 
     int shader = glCreateShader(type); //Napravimo prazan sejder odredjenog tipa (vertex ili fragment)
 
@@ -54,39 +82,189 @@ unsigned int compileShader(GLenum type, const char* source)
         else if (type == GL_FRAGMENT_SHADER)
             printf("FRAGMENT");
         printf(" sejder ima gresku! Greska: \n");
-        printf(infoLog);
+        printf("%s", infoLog);
+        glDeleteShader(shader);
+        return 0;
     }
     return shader;
 }
-unsigned int createShader(const char* vsSource, const char* fsSource)
+
+// Kes povezanih programa (glGetProgramBinary): jedan fajl po paru sejdera, a u njemu kljuc od
+// izvornog koda i drajvera. Drugi kod ili drugi drajver (ili nova verzija) = ponovno prevodjenje.
+static const uint32_t PROGRAM_CACHE_MAGIC = 0x31425053; // "SPB1"
+static std::string programCacheDirectory = "shader_cache";
+
+struct ProgramCacheHeader {
+    uint32_t magic;
+    uint32_t format;   // binaryFormat iz glGetProgramBinary
+    uint32_t length;
+    uint32_t reserved;
+    uint64_t key;
+};
+
+// FNV-1a preko bajtova
+static uint64_t hashString(uint64_t h, const std::string& s)
 {
-    //Pravi objedinjeni sejder program koji se sastoji od Vertex sejdera ciji je kod na putanji vsSource
+    for (unsigned char c : s)
+    {
+        h ^= c;
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
 
-    unsigned int program; //Objedinjeni sejder
-    unsigned int vertexShader; //Verteks sejder (za prostorne podatke)
-    unsigned int fragmentShader; //Fragment sejder (za boje, teksture itd)
+static std::string glString(GLenum name)
+{
+    const GLubyte* s = glGetString(name);
+    return s ? (const char*)s : "";
+}
 
-    program = glCreateProgram(); //Napravi prazan objedinjeni sejder program
+static bool programBinarySupported()
+{
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
 
-    vertexShader = compileShader(GL_VERTEX_SHADER, vsSource); //Napravi i kompajliraj vertex sejder
-    fragmentShader = compileShader(GL_FRAGMENT_SHADER, fsSource); //Napravi i kompajliraj fragment sejder
+static std::string programCachePath(const char* vsSource, const char* fsSource)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.bin",
+        (unsigned long long)hashString(0xCBF29CE484222325ull, std::string(vsSource) + "|" + fsSource));
+    return programCacheDirectory + name;
+}
+
+// Program iz kesa; 0 ako ga nema, ako je za drugi kljuc ili ga drajver vise ne prihvata
+static unsigned int loadCachedProgram(const std::string& path, uint64_t key)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == NULL) return 0;
+    ProgramCacheHeader header;
+    std::vector<char> binary;
+    if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == PROGRAM_CACHE_MAGIC && header.key == key)
+    {
+        binary.resize(header.length);
+        if (fread(binary.data(), 1, binary.size(), file) != binary.size()) binary.clear();
+    }
+    fclose(file);
+    if (binary.empty()) return 0;
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void storeCachedProgram(const std::string& path, uint64_t key, unsigned int program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+#ifdef _WIN32
+    _mkdir(programCacheDirectory.c_str());
+#else
+    mkdir(programCacheDirectory.c_str(), 0755);
+#endif
+    //Zapis ide u privremeni fajl (po procesu) pa se preimenuje: kiosk i displej koji krenu zajedno
+    //nikad ne citaju pola zapisa
+#ifdef _WIN32
+    std::string tmpPath = path + "." + std::to_string(_getpid()) + ".tmp";
+#else
+    std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (file == NULL) return;
+    ProgramCacheHeader header = { PROGRAM_CACHE_MAGIC, format, (uint32_t)length, 0, key };
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(binary.data(), 1, length, file) == (size_t)length;
+    ok = fclose(file) == 0 && ok;
+    remove(path.c_str());
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) remove(tmpPath.c_str());
+}
+
+void setShaderCacheDirectory(const std::string& directory)
+{
+    programCacheDirectory = directory;
+}
+
+static unsigned int linkShader(const char* vsSource, const char* fsSource, bool fromFiles)
+{
+    //Pravi objedinjeni sejder program od Vertex sejdera vsSource i Fragment sejdera fsSource; 0 ako nesto ne uspije
+    auto start = std::chrono::steady_clock::now();
+    std::string vsCode, fsCode;
+    if (!readShaderSource(vsSource, fromFiles, vsCode) || !readShaderSource(fsSource, fromFiles, fsCode)) return 0;
+
+    //Povezan program iz kesa, ako je za isti kod i isti drajver
+    bool useCache = !programCacheDirectory.empty() && programBinarySupported();
+    std::string cachePath;
+    uint64_t key = 0xCBF29CE484222325ull;
+    if (useCache)
+    {
+        cachePath = programCachePath(vsSource, fsSource);
+        key = hashString(key, vsCode);
+        key = hashString(key, fsCode);
+        key = hashString(key, glString(GL_VENDOR));
+        key = hashString(key, glString(GL_RENDERER));
+        key = hashString(key, glString(GL_VERSION));
+        unsigned int cached = loadCachedProgram(cachePath, key);
+        if (cached != 0)
+        {
+            std::cout << "Sejder program iz kesa za "
+                << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+            return cached;
+        }
+    }
+
+    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vsCode); //Napravi i kompajliraj vertex sejder
+    unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fsCode); //Napravi i kompajliraj fragment sejder
+    if (vertexShader == 0 || fragmentShader == 0)
+    {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram(); //Napravi prazan objedinjeni sejder program
+    if (useCache) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
     //Zakaci verteks i fragment sejdere za objedinjeni program
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
 
     glLinkProgram(program); //Povezi ih u jedan objedinjeni sejder program
-    glValidateProgram(program); //Izvrsi provjeru novopecenog programa
 
     int success;
     char infoLog[512];
-    glGetProgramiv(program, GL_VALIDATE_STATUS, &success); //Slicno kao za sejdere
+    glGetProgramiv(program, GL_LINK_STATUS, &success); //Slicno kao za sejdere
     if (success == GL_FALSE)
     {
-        glGetShaderInfoLog(program, 512, NULL, infoLog);
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
         std::cout << "Objedinjeni sejder ima gresku! Greska: \n";
         std::cout << infoLog << std::endl;
     }
+    else
+    {
+        //Provjera zavisi od trenutnog GL stanja (npr. jos nema VAO), pa je neuspjeh samo upozorenje
+        int valid;
+        glValidateProgram(program);
+        glGetProgramiv(program, GL_VALIDATE_STATUS, &valid);
+        if (valid == GL_FALSE)
+        {
+            glGetProgramInfoLog(program, 512, NULL, infoLog);
+            std::cout << "Upozorenje: provjera objedinjenog sejdera nije prosla u trenutnom stanju: \n";
+            std::cout << infoLog << std::endl;
+        }
+    }
 
     //Posto su kodovi sejdera u objedinjenom sejderu, oni pojedinacni programi nam ne trebaju, pa ih brisemo zarad ustede na memoriji
     glDetachShader(program, vertexShader);
@@ -94,18 +272,35 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     glDetachShader(program, fragmentShader);
     glDeleteShader(fragmentShader);
 
+    if (success == GL_FALSE)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    std::cout << "Sejder program preveden za "
+        << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+    if (useCache) storeCachedProgram(cachePath, key, program);
     return program;
 }
 
+unsigned int createShader(const char* vsSource, const char* fsSource)
+{
+    return linkShader(vsSource, fsSource, false);
+}
+
+unsigned int createShaderFromFiles(const char* vsPath, const char* fsPath)
+{
+    return linkShader(vsPath, fsPath, true);
+}
+
 unsigned loadImageToTexture(const char* filePath) {
     int TextureWidth;
     int TextureHeight;
     int TextureChannels;
-    unsigned char* ImageData = stbi_load(filePath, &TextureWidth, &TextureHeight, &TextureChannels, 0);
+    //Slike se osnovno ucitavaju naopako pa se moraju ispraviti da budu uspravne (kes cuva vec ispravljene)
+    unsigned char* ImageData = loadImageCached(filePath, &TextureWidth, &TextureHeight, &TextureChannels, 0, true);
     if (ImageData != NULL)
     {
-        //Slike se osnovno ucitavaju naopako pa se moraju ispraviti da budu uspravne
-        stbi__vertical_flip(ImageData, TextureWidth, TextureHeight, TextureChannels);
 
         // Provjerava koji je format boja ucitane slike
         GLint InternalFormat = -1;
@@ -147,7 +342,7 @@ GLFWcursor* loadImageToCursor(const char* filePath) {
     int TextureChannels;
 
     // Forsiramo 4 kanala (RGBA)
-    unsigned char* ImageData = stbi_load(filePath, &TextureWidth, &TextureHeight, &TextureChannels, 4);
+    unsigned char* ImageData = loadImageCached(filePath, &TextureWidth, &TextureHeight, &TextureChannels, 4, false);
 
     if (ImageData != NULL) {
         GLFWimage image;
@@ -2,17 +2,37 @@
 
 layout(location = 0) in vec2 inPos; // Ulazne koordinate (samo X i Y su nam dovoljne za 2D)
 layout(location = 1) in vec2 inTex; // Teksturne koordinate
+layout(location = 2) in vec4 inInstRect;  // Po instanci: pozicija (xy) i velicina (zw) - koristi se kad je uInstanced
+layout(location = 3) in vec4 inInstColor; // Po instanci: boja
+layout(location = 4) in vec4 inInstUv;    // Po instanci: deo teksture (pocetak xy, velicina zw); zw = 0 bez teksture
 
 out vec2 chTex; // Saljemo teksturne koordinate u fragment shader
+out vec4 chCol; // Boja objekta (iz uniforme ili iz instance)
+flat out int chTextured; // Da li fragment shader cita teksturu
 
 uniform vec2 uPos;   // Gde se objekat nalazi (X, Y) - NDC koordinate (-1 do 1)
 uniform vec2 uSize;  // Koliki je objekat (Sirina, Visina)
+uniform vec4 uColor; // Boja objekta (R, G, B, A)
+uniform bool uInstanced; // Da li pozicija, velicina i boja dolaze iz instance (npr. sva sedista u jednom pozivu)
+uniform vec4 uUvRect;    // Deo teksture koji se crta (pocetak xy, velicina zw) - sprajt u atlasu
+uniform bool uUseTexture; // Da li koristimo teksturu ili boju (bez instanci)
 
 void main()
 {
     // Formula: (Originalna_Pozicija * Velicina) + Pozicija
     // Ovo simulira model matricu za jednostavne 2D pravougaonike
-    gl_Position = vec4(inPos * uSize + uPos, 0.0, 1.0);
-    
-    chTex = inTex;
+    if (uInstanced)
+    {
+        gl_Position = vec4(inPos * inInstRect.zw + inInstRect.xy, 0.0, 1.0);
+        chCol = inInstColor;
+        chTex = inInstUv.xy + inTex * inInstUv.zw;
+        chTextured = inInstUv.z > 0.0 ? 1 : 0;
+    }
+    else
+    {
+        gl_Position = vec4(inPos * uSize + uPos, 0.0, 1.0);
+        chCol = uColor;
+        chTex = uUvRect.xy + inTex * uUvRect.zw;
+        chTextured = uUseTexture ? 1 : 0;
+    }
 }
\ No newline at end of file